@@ -0,0 +1,115 @@
+// std
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <stdexcept>
+// matlib
+#include "mat.hpp"
+
+using namespace matlib;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+using Elem = std::int64_t;
+
+// keeps the compiler from dropping the measured loop
+volatile Elem sink;
+
+// the access path before checking policies: optional offset, an abort
+// check, then std::vector::at
+Elem legacy_at(const Matrix<Elem> &mat, Size_T r, Size_T c) {
+    auto shape = mat.get_shape();
+    std::optional<Size_T> offset;
+    if (r < shape.first && c < shape.second) {
+        offset = r * shape.second + c;
+    }
+    if (!offset) {
+        std::abort();
+    }
+    if (offset.value() >= shape.first * shape.second) {
+        throw std::out_of_range("legacy_at");
+    }
+    return mat.raw_data()[offset.value()];
+}
+
+template<typename F>
+double ns_per_access(Size_T accesses, int repeat, F &&f) {
+    double best = 1e300;
+    for (int t = 0; t < repeat; ++t) {
+        auto start = Clock::now();
+        sink = f();
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        best = std::min(best, elapsed.count() / static_cast<double>(accesses));
+    }
+    return best;
+}
+
+}
+
+int main() {
+    const Size_T n = 1024;
+    const int repeat = 20;
+    Matrix<Elem> mat (n, n);
+    for (Size_T i = 0; i < n; ++i) {
+        for (Size_T j = 0; j < n; ++j) {
+            mat.unsafe_at(i, j) = static_cast<Elem>((i + j) % 7);
+        }
+    }
+    auto slice = mat.slice(0, n - 1, 0, n - 1);
+
+    double t_legacy = ns_per_access(n * n, repeat, [&]() {
+        Elem acc = 0;
+        for (Size_T i = 0; i < n; ++i) {
+            for (Size_T j = 0; j < n; ++j) {
+                acc += legacy_at(mat, i, j);
+            }
+        }
+        return acc;
+    });
+    double t_at = ns_per_access(n * n, repeat, [&]() {
+        Elem acc = 0;
+        for (Size_T i = 0; i < n; ++i) {
+            for (Size_T j = 0; j < n; ++j) {
+                acc += mat.at(i, j);
+            }
+        }
+        return acc;
+    });
+    double t_unsafe = ns_per_access(n * n, repeat, [&]() {
+        Elem acc = 0;
+        for (Size_T i = 0; i < n; ++i) {
+            for (Size_T j = 0; j < n; ++j) {
+                acc += mat.unsafe_at(i, j);
+            }
+        }
+        return acc;
+    });
+    double t_slice = ns_per_access(n * n, repeat, [&]() {
+        Elem acc = 0;
+        for (Size_T i = 0; i < n; ++i) {
+            for (Size_T j = 0; j < n; ++j) {
+                acc += slice.at(i, j);
+            }
+        }
+        return acc;
+    });
+    double t_raw = ns_per_access(n * n, repeat, [&]() {
+        Elem acc = 0;
+        const Elem *p = mat.raw_data();
+        for (Size_T i = 0; i < n * n; ++i) {
+            acc += p[i];
+        }
+        return acc;
+    });
+
+    std::printf("check level %d, %zux%zu int64 matrix\n", MATLIB_CHECK_LEVEL, n, n);
+    std::printf("  legacy at         %6.3f ns/access\n", t_legacy);
+    std::printf("  Matrix::at        %6.3f ns/access\n", t_at);
+    std::printf("  Matrix::unsafe_at %6.3f ns/access\n", t_unsafe);
+    std::printf("  Slice::at         %6.3f ns/access\n", t_slice);
+    std::printf("  raw pointer       %6.3f ns/access\n", t_raw);
+    return 0;
+}
@@ -0,0 +1,79 @@
+// std
+#include <chrono>
+#include <cstdio>
+#include <random>
+// matlib
+#include "mat.hpp"
+
+using namespace matlib;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+Size_T file_size(const char *path) {
+    std::FILE *file = std::fopen(path, "rb");
+    std::fseek(file, 0, SEEK_END);
+    auto retval = static_cast<Size_T>(std::ftell(file));
+    std::fclose(file);
+    return retval;
+}
+
+template<typename F>
+double seconds(F &&f) {
+    auto start = Clock::now();
+    f();
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+
+void report(const char *what, Size_T bytes, double sec, Size_T threads) {
+    double mb = static_cast<double>(bytes) / (1 << 20);
+    std::printf("  %-22s %8.1f MB/s  %8.1f MB/s/thread\n", what, mb / sec,
+        mb / sec / static_cast<double>(threads));
+}
+
+}
+
+int main() {
+    const Size_T NR = 4000, NC = 1000;
+    Matrix<double> mat (NR, NC);
+    std::mt19937_64 rng (42);
+    std::uniform_real_distribution<double> dist (-1e3, 1e3);
+    for (auto it = mat.raw_begin(); it != mat.raw_end(); ++it) {
+        *it = dist(rng);
+    }
+    // sparse copy for the coordinate format
+    Matrix<double> sparse (NR, NC);
+    for (Size_T i = 0; i < NR * NC; i += 13) {
+        sparse.raw_data()[i] = mat.raw_data()[i];
+    }
+
+    const char *csv = "io_bench.csv";
+    const char *mtx = "io_bench.mtx";
+    for (Size_T threads : {Size_T{1}, get_num_threads()}) {
+        set_num_threads(threads);
+        std::printf("%zux%zu double, %zu thread(s)\n", NR, NC, threads);
+
+        double t = seconds([&]() { write_csv(csv, mat); });
+        report("write_csv", file_size(csv), t, threads);
+        t = seconds([&]() { read_csv<double>(csv); });
+        report("read_csv", file_size(csv), t, threads);
+
+        t = seconds([&]() { write_matrix_market(mtx, mat, MMFormat::Array); });
+        report("write mtx array", file_size(mtx), t, threads);
+        t = seconds([&]() { read_matrix_market<double>(mtx); });
+        report("read mtx array", file_size(mtx), t, threads);
+
+        t = seconds([&]() { write_matrix_market(mtx, sparse); });
+        report("write mtx coordinate", file_size(mtx), t, threads);
+        t = seconds([&]() { read_matrix_market<double>(mtx); });
+        report("read mtx coordinate", file_size(mtx), t, threads);
+        if (threads == get_num_threads()) {
+            break;
+        }
+    }
+    std::remove(csv);
+    std::remove(mtx);
+    return 0;
+}
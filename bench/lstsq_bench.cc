@@ -0,0 +1,110 @@
+// std
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+// matlib
+#include "mat.hpp"
+
+using namespace matlib;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template<typename F>
+double seconds(F &&f) {
+    auto start = Clock::now();
+    f();
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+
+// the previous path: form A^T A and A^T b, then PLU and two substitutions
+Vector<double> normal_plu(const Matrix<double> &A, const Vector<double> &b) {
+    auto At = A.transpose();
+    auto AtA = At * A;
+    Vector<double> Atb = At * b;
+    auto [P, L, U] = PLU_decomposite(AtA);
+    Vector<double> x = P * Atb;
+    Size_T n = x.size();
+    for (Size_T i = 0; i < n; ++i) {
+        for (Size_T k = 0; k < i; ++k) {
+            x.unsafe_at(i) -= L.unsafe_at(i, k) * x.unsafe_at(k);
+        }
+    }
+    for (Size_T i = n; i-- > 0;) {
+        for (Size_T k = i + 1; k < n; ++k) {
+            x.unsafe_at(i) -= U.unsafe_at(i, k) * x.unsafe_at(k);
+        }
+        x.unsafe_at(i) /= U.unsafe_at(i, i);
+    }
+    return x;
+}
+
+Vector<double> normal_cholesky(const Matrix<double> &A, const Vector<double> &b) {
+    auto At = A.transpose();
+    return spd_solve(At * A, At * b);
+}
+
+double relative_error(const Vector<double> &x, const Vector<double> &ref) {
+    return nrm2(x - ref) / nrm2(ref);
+}
+
+}
+
+/// usage: lstsq_bench [n ...], solves 2n x n problems, defaults to 200 400 800
+///
+/// Singular values are graded from 1 down to 1e-6 so cond(A) is 1e6 and the
+/// normal equations square it; the error columns show what that costs.
+int main(int argc, char **argv) {
+    std::vector<Size_T> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes = {200, 400, 800};
+    }
+
+    std::mt19937_64 rng (11);
+    std::uniform_real_distribution<double> dist (-1, 1);
+    std::printf("%6s | %-22s | %-22s | %-22s\n", "n",
+        "normal eq + PLU", "normal eq + Cholesky", "Householder QR");
+    for (Size_T n : sizes) {
+        Size_T m = 2 * n;
+        // A = U diag(s) W^T with orthonormal U, W from QR of random matrices
+        Matrix<double> G (m, n), H (n, n);
+        for (auto it = G.raw_begin(); it != G.raw_end(); ++it) {
+            *it = dist(rng);
+        }
+        for (auto it = H.raw_begin(); it != H.raw_end(); ++it) {
+            *it = dist(rng);
+        }
+        auto U = std::get<0>(QR_decomposite(G));
+        auto W = std::get<0>(QR_decomposite(H));
+        for (Size_T j = 0; j < n; ++j) {
+            double s = std::pow(1e-6, static_cast<double>(j) / static_cast<double>(n - 1 ? n - 1 : 1));
+            for (Size_T i = 0; i < m; ++i) {
+                U.unsafe_at(i, j) *= s;
+            }
+        }
+        Matrix<double> A = U * W.transpose();
+        Vector<double> x_true (n);
+        for (Size_T j = 0; j < n; ++j) {
+            x_true.unsafe_at(j) = dist(rng);
+        }
+        Vector<double> b = A * x_true;
+
+        Vector<double> x_plu (n), x_chol (n), x_qr (n);
+        double t_plu = seconds([&]() { x_plu = normal_plu(A, b); });
+        double t_chol = seconds([&]() { x_chol = normal_cholesky(A, b); });
+        double t_qr = seconds([&]() { x_qr = least_squares(A, b); });
+        std::printf("%6zu | %7.3f s  err %8.1e | %7.3f s  err %8.1e | %7.3f s  err %8.1e\n", n,
+            t_plu, relative_error(x_plu, x_true),
+            t_chol, relative_error(x_chol, x_true),
+            t_qr, relative_error(x_qr, x_true));
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+// std
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+// matlib
+#include "mat.hpp"
+
+using namespace matlib;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template<typename F>
+double seconds(F &&f) {
+    auto start = Clock::now();
+    f();
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+
+}
+
+/// usage: strassen_bench [n ...], defaults to 512 1024 2048
+int main(int argc, char **argv) {
+    std::vector<Size_T> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes = {512, 1024, 2048};
+    }
+    Size_T cutoffs[] = {128, 256, 512};
+
+    std::mt19937_64 rng (7);
+    std::uniform_real_distribution<double> dist (-1, 1);
+    set_strassen_threshold(0);
+    std::printf("%6s %12s", "n", "classical");
+    for (Size_T cutoff : cutoffs) {
+        std::printf("   cutoff %-4zu", cutoff);
+    }
+    std::printf("\n");
+
+    for (Size_T n : sizes) {
+        Matrix<double> A (n, n), B (n, n);
+        for (auto it = A.raw_begin(); it != A.raw_end(); ++it) {
+            *it = dist(rng);
+        }
+        for (auto it = B.raw_begin(); it != B.raw_end(); ++it) {
+            *it = dist(rng);
+        }
+        std::vector<double> workspace;
+        double base = seconds([&]() { auto C = A * B; });
+        std::printf("%6zu %10.3f s", n, base);
+        for (Size_T cutoff : cutoffs) {
+            double t = seconds([&]() { auto C = strassen_multiply(A, B, workspace, cutoff); });
+            // speedup above 1 means Strassen-Winograd won at this size
+            std::printf("  %6.3f (x%.2f)", t, base / t);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+// std
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <tuple>
+#include <vector>
+// matlib
+#include "mat.hpp"
+
+using namespace matlib;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template<typename F>
+double seconds(F &&f) {
+    auto start = Clock::now();
+    f();
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+
+Matrix<double> random_matrix(Size_T NR, Size_T NC, std::mt19937_64 &rng) {
+    std::uniform_real_distribution<double> dist (-1, 1);
+    Matrix<double> retval (NR, NC);
+    for (auto it = retval.raw_begin(); it != retval.raw_end(); ++it) {
+        *it = dist(rng);
+    }
+    return retval;
+}
+
+// m x n with singular values 1 / (1 + i)
+Matrix<double> test_matrix(Size_T m, Size_T n, std::mt19937_64 &rng) {
+    auto U = std::get<0>(QR_decomposite(random_matrix(m, n, rng)));
+    auto W = std::get<0>(QR_decomposite(random_matrix(n, n, rng)));
+    for (Size_T j = 0; j < n; ++j) {
+        double s = 1. / (1. + static_cast<double>(j));
+        for (Size_T i = 0; i < m; ++i) {
+            U.unsafe_at(i, j) *= s;
+        }
+    }
+    return U * W.transpose();
+}
+
+double error(const Matrix<double> &A, const std::tuple<Matrix<double>, Vector<double>, Matrix<double>> &usv) {
+    auto US = std::get<0>(usv);
+    const auto &S = std::get<1>(usv);
+    for (Size_T i = 0; i < US.get_shape().first; ++i) {
+        for (Size_T j = 0; j < S.size(); ++j) {
+            US.unsafe_at(i, j) *= S.unsafe_at(j);
+        }
+    }
+    return norm_fro(US * std::get<2>(usv) - A);
+}
+
+}
+
+/// usage: svd_bench [rank] [m n ...], defaults to rank 20 on 200 x 150,
+/// 400 x 300 and 600 x 450, the exact reference limits the size
+///
+/// Each line shows time, rows per second and the Frobenius error relative
+/// to the optimal rank-k error from the exact Jacobi SVD (x1.000 is
+/// optimal); the exact column shows its relative reconstruction error.
+int main(int argc, char **argv) {
+    Size_T rank = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20;
+    std::vector<std::pair<Size_T, Size_T>> shapes;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        shapes.emplace_back(std::strtoull(argv[i], nullptr, 10), std::strtoull(argv[i + 1], nullptr, 10));
+    }
+    if (shapes.empty()) {
+        shapes = {{200, 150}, {400, 300}, {600, 450}};
+    }
+    const Size_T block_rows = 256;
+
+    std::mt19937_64 rng (5);
+    std::printf("%6s %6s  %-26s %-26s %-26s %-26s\n", "m", "n", "exact Jacobi",
+        "randomized q=0", "randomized q=2", "streaming");
+    for (auto [m, n] : shapes) {
+        auto A = test_matrix(m, n, rng);
+        std::tuple<Matrix<double>, Vector<double>, Matrix<double>> exact {Matrix<double>(0, 0), Vector<double>(0), Matrix<double>(0, 0)};
+        double t_exact = seconds([&]() { exact = SVD_decomposite(A); });
+        double best = 0;
+        for (Size_T i = rank; i < std::get<1>(exact).size(); ++i) {
+            best += std::get<1>(exact).unsafe_at(i) * std::get<1>(exact).unsafe_at(i);
+        }
+        best = std::sqrt(best);
+
+        auto report = [&](double t, double e) {
+            std::printf(" %7.3f s %8.0f r/s  x%.3f", t, static_cast<double>(m) / t, e / best);
+        };
+        std::printf("%6zu %6zu ", m, n);
+        // the full decomposition, so show its reconstruction error instead
+        std::printf(" %7.3f s %8.0f r/s  %.0e", t_exact, static_cast<double>(m) / t_exact,
+            error(A, exact) / norm_fro(A));
+        for (Size_T q : {0, 2}) {
+            std::tuple<Matrix<double>, Vector<double>, Matrix<double>> usv = exact;
+            double t = seconds([&]() { usv = randomized_svd(A, rank, 10, q); });
+            report(t, error(A, usv));
+        }
+        std::tuple<Matrix<double>, Vector<double>, Matrix<double>> usv = exact;
+        double t = seconds([&]() {
+            StreamingSVD<double> sketch (n, rank, 10);
+            for (Size_T b = 0; b < m; b += block_rows) {
+                Size_T e = std::min(m, b + block_rows);
+                Matrix<double> block (e - b, n);
+                std::copy(A.raw_data() + b * n, A.raw_data() + e * n, block.raw_data());
+                sketch.push_rows(block);
+            }
+            usv = sketch.finalize();
+        });
+        report(t, error(A, usv));
+        std::printf("\n");
+    }
+    return 0;
+}
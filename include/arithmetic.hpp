@@ -1,9 +1,13 @@
 #include "utility.hpp"
 #include "common.hpp"
+#include "blas.hpp"
+#include "strassen.hpp"
 
 namespace matlib {
 
 template<typename> class Matrix;
+template<typename> class Vector;
+template<typename, typename> class VectorView;
 
 /// basic operations
 template<
@@ -43,7 +47,7 @@ template<
     typename V,
     typename U>
 auto operator+(const Matrix<V> &lhs, const Matrix<U> &rhs) {
-    ASSERT_MSG(lhs.get_shape() == rhs.get_shape(), "Shape must match for addition.");
+    MATLIB_CHECK(V, Assert, lhs.get_shape() == rhs.get_shape(), "Shape must match for addition.");
     Matrix<decltype(V{} + U{})> retval(lhs.get_shape());
     auto shape = lhs.get_shape();
     auto tot = shape.first * shape.second;
@@ -63,7 +67,7 @@ template<
     typename V,
     typename U>
 auto operator-(const Matrix<V> &lhs, const Matrix<U> &rhs) {
-    ASSERT_MSG(lhs.get_shape() == rhs.get_shape(), "Shape must match for subtraction.");
+    MATLIB_CHECK(V, Assert, lhs.get_shape() == rhs.get_shape(), "Shape must match for subtraction.");
     Matrix<decltype(V{} + U{})> retval(lhs.get_shape());
     auto shape = lhs.get_shape();
     auto tot = shape.first * shape.second;
@@ -111,30 +115,147 @@ auto operator*(const Matrix<V> &rhs, U k) {
     return retval;
 }
 
-// TODO: directly index on raw array to accelerate
 template<
     typename V,
     typename U>
 auto operator*(const Matrix<V> &lhs, const Matrix<U> &rhs) {
     using Return_T = decltype(decltype(V{} + U{}){} * decltype(V{} + U{}){});
-    ASSERT_MSG(lhs.get_shape().second == rhs.get_shape().first,
+    MATLIB_CHECK(V, Assert, lhs.get_shape().second == rhs.get_shape().first,
         "Shape must match for multiplication.");
     
     auto lshape = lhs.get_shape(); 
     auto rshape = rhs.get_shape();
 
     Matrix<Return_T> retval(lshape.first, rshape.second);
-    for (Size_T r = 0; r < lshape.first; ++r) {
-        for (Size_T c = 0; c < rshape.second; ++c) {
-            Return_T cur{};
-            for (Size_T k = 0; k < lshape.second; ++k) {
-                cur = cur + lhs.unsafe_at(r, k) * rhs.unsafe_at(k, c);
-            }
-            retval.unsafe_at(r, c) = cur;
+    if (rshape.second == 1) {
+        detail::gemv_kernel(lshape.first, lshape.second, Default<Return_T>::one,
+            lhs.raw_data(), lshape.second, rhs.raw_data(), 1,
+            Default<Return_T>::zero, retval.raw_data(), 1);
+        return retval;
+    }
+    if constexpr (std::is_same_v<V, U> && std::is_same_v<V, Return_T>) {
+        Size_T threshold = get_strassen_threshold();
+        if (threshold > 0 && std::min({lshape.first, lshape.second, rshape.second}) >= threshold) {
+            return strassen_multiply(lhs, rhs);
         }
     }
+    detail::gemm_kernel(lshape.first, lshape.second, rshape.second, Default<Return_T>::one,
+        lhs.raw_data(), lshape.second, rhs.raw_data(), rshape.second,
+        Default<Return_T>::zero, retval.raw_data(), rshape.second);
+
+    return retval;
+}
+
+/// vector operations
+template<
+    typename V,
+    typename U>
+bool operator==(const Vector<V> &lhs, const Vector<U> &rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+
+    auto p_lhs = lhs.raw_data();
+    auto p_rhs = rhs.raw_data();
+    for (Size_T i = 0; i < lhs.size(); ++i) {
+        if (!ValueEq(p_lhs[i], p_rhs[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<
+    typename V,
+    typename U>
+bool operator!=(const Vector<V> &lhs, const Vector<U> &rhs) {
+    return !(lhs == rhs);
+}
+
+template<
+    typename V,
+    typename U>
+auto operator+(const Vector<V> &lhs, const Vector<U> &rhs) {
+    MATLIB_CHECK(V, Assert, lhs.size() == rhs.size(), "Size must match for addition.");
+    Vector<decltype(V{} + U{})> retval(lhs.size());
+
+    auto p_lhs = lhs.raw_data();
+    auto p_rhs = rhs.raw_data();
+    auto p_ret = retval.raw_data();
+
+    for (Size_T i = 0; i < lhs.size(); ++i) {
+        p_ret[i] = p_lhs[i] + p_rhs[i];
+    }
+
+    return retval;
+}
+
+template<
+    typename V,
+    typename U>
+auto operator-(const Vector<V> &lhs, const Vector<U> &rhs) {
+    MATLIB_CHECK(V, Assert, lhs.size() == rhs.size(), "Size must match for subtraction.");
+    Vector<decltype(V{} + U{})> retval(lhs.size());
+
+    auto p_lhs = lhs.raw_data();
+    auto p_rhs = rhs.raw_data();
+    auto p_ret = retval.raw_data();
+
+    for (Size_T i = 0; i < lhs.size(); ++i) {
+        p_ret[i] = p_lhs[i] - p_rhs[i];
+    }
 
     return retval;
 }
 
+template<
+    typename V,
+    typename U>
+auto operator*(U k, const Vector<V> &rhs) {
+    Vector<V> retval (rhs.size(), rhs.raw_data());
+    scal(k, retval);
+    return retval;
+}
+
+template<
+    typename V,
+    typename U>
+auto operator*(const Vector<V> &lhs, U k) {
+    return k * lhs;
+}
+
+/// matrix-vector product through gemv
+template<
+    typename V,
+    typename U>
+auto operator*(const Matrix<V> &lhs, const Vector<U> &rhs) {
+    using Return_T = decltype(decltype(V{} + U{}){} * decltype(V{} + U{}){});
+    Vector<Return_T> retval(lhs.get_shape().first);
+    gemv(Default<Return_T>::one, lhs, rhs, Default<Return_T>::zero, retval);
+    return retval;
+}
+
+template<
+    typename V,
+    typename U,
+    typename MatType>
+auto operator*(const Matrix<V> &lhs, const VectorView<U, MatType> &rhs) {
+    using Return_T = decltype(decltype(V{} + U{}){} * decltype(V{} + U{}){});
+    Vector<Return_T> retval(lhs.get_shape().first);
+    gemv(Default<Return_T>::one, lhs, rhs, Default<Return_T>::zero, retval);
+    return retval;
+}
+
+/// row vector times matrix, x^T * A
+template<
+    typename V,
+    typename U>
+auto operator*(const Vector<U> &lhs, const Matrix<V> &rhs) {
+    using Return_T = decltype(decltype(V{} + U{}){} * decltype(V{} + U{}){});
+    Vector<Return_T> retval(rhs.get_shape().second);
+    gemv_t(Default<Return_T>::one, rhs, lhs, Default<Return_T>::zero, retval);
+    return retval;
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,387 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+// matlib
+#include "common.hpp"
+#include "utility.hpp"
+#include "parallel.hpp"
+#include "vector.hpp"
+
+
+/// level-1, level-2 and level-3 kernels on raw strided storage
+///
+/// The unit-stride paths keep `Lanes` independent accumulators so that the
+/// compiler can map them onto SIMD registers without reassociating floating
+/// point sums; strided paths fall back to the scalar loop.
+namespace matlib::detail {
+
+inline constexpr Size_T Lanes = 8;
+// minimum work per thread, in elements touched
+inline constexpr Size_T level1_grain = Size_T{1} << 15;
+inline constexpr Size_T level2_grain = Size_T{1} << 15;
+inline constexpr Size_T level3_grain = Size_T{1} << 18;
+// gemm register tile and cache blocks
+inline constexpr Size_T gemm_mr = 4;
+inline constexpr Size_T gemm_nr = 8;
+inline constexpr Size_T gemm_kc = 256;
+inline constexpr Size_T gemm_nc = 256;
+
+template<
+    typename R,
+    typename X,
+    typename Y>
+R dot_serial(Size_T n, const X *x, Size_T incx, const Y *y, Size_T incy) {
+    if (incx == 1 && incy == 1) {
+        R acc[Lanes] = {};
+        Size_T i = 0;
+        for (; i + Lanes <= n; i += Lanes) {
+            for (Size_T l = 0; l < Lanes; ++l) {
+                acc[l] += x[i + l] * y[i + l];
+            }
+        }
+        R tail{};
+        for (; i < n; ++i) {
+            tail += x[i] * y[i];
+        }
+        for (Size_T w = Lanes / 2; w > 0; w /= 2) {
+            for (Size_T l = 0; l < w; ++l) {
+                acc[l] += acc[l + w];
+            }
+        }
+        return acc[0] + tail;
+    }
+    R acc{};
+    for (Size_T i = 0; i < n; ++i) {
+        acc += x[i * incx] * y[i * incy];
+    }
+    return acc;
+}
+
+template<
+    typename R,
+    typename X,
+    typename Y>
+R dot_kernel(Size_T n, const X *x, Size_T incx, const Y *y, Size_T incy) {
+    return parallel_reduce(Size_T{0}, n, level1_grain, R{},
+        [=](Size_T b, Size_T e) {
+            return dot_serial<R>(e - b, x + b * incx, incx, y + b * incy, incy);
+        },
+        [](R a, R b) { return a + b; });
+}
+
+template<
+    typename S,
+    typename X,
+    typename Y>
+void axpy_serial(Size_T n, S alpha, const X *x, Size_T incx, Y *y, Size_T incy) {
+    if (incx == 1 && incy == 1) {
+        for (Size_T i = 0; i < n; ++i) {
+            y[i] += alpha * x[i];
+        }
+        return;
+    }
+    for (Size_T i = 0; i < n; ++i) {
+        y[i * incy] += alpha * x[i * incx];
+    }
+}
+
+template<
+    typename S,
+    typename X,
+    typename Y>
+void axpy_kernel(Size_T n, S alpha, const X *x, Size_T incx, Y *y, Size_T incy) {
+    parallel_for(Size_T{0}, n, level1_grain, [=](Size_T b, Size_T e) {
+        axpy_serial(e - b, alpha, x + b * incx, incx, y + b * incy, incy);
+    });
+}
+
+template<
+    typename S,
+    typename X>
+void scal_serial(Size_T n, S alpha, X *x, Size_T incx) {
+    if (incx == 1) {
+        for (Size_T i = 0; i < n; ++i) {
+            x[i] *= alpha;
+        }
+        return;
+    }
+    for (Size_T i = 0; i < n; ++i) {
+        x[i * incx] *= alpha;
+    }
+}
+
+template<
+    typename S,
+    typename X>
+void scal_kernel(Size_T n, S alpha, X *x, Size_T incx) {
+    parallel_for(Size_T{0}, n, level1_grain, [=](Size_T b, Size_T e) {
+        scal_serial(e - b, alpha, x + b * incx, incx);
+    });
+}
+
+template<typename X>
+auto nrm2_kernel(Size_T n, const X *x, Size_T incx) {
+    using std::sqrt;
+    using std::abs;
+    using R = decltype(sqrt(X{}));
+    R ssq = dot_kernel<R>(n, x, incx, x, incx);
+    // fast path unless the sum of squares under- or overflowed
+    if (ssq >= std::numeric_limits<R>::min() && ssq <= std::numeric_limits<R>::max()) {
+        return sqrt(ssq);
+    }
+    R scale{};
+    for (Size_T i = 0; i < n; ++i) {
+        scale = std::max<R>(scale, abs(x[i * incx]));
+    }
+    if (scale == R{} || !(scale <= std::numeric_limits<R>::max())) {
+        return scale;
+    }
+    R acc{};
+    for (Size_T i = 0; i < n; ++i) {
+        R t = x[i * incx] / scale;
+        acc += t * t;
+    }
+    return scale * sqrt(acc);
+}
+
+/// y = alpha * A * x + beta * y, A is M x N row-major with leading dim lda
+template<
+    typename S,
+    typename A,
+    typename X,
+    typename T,
+    typename Y>
+void gemv_kernel(Size_T M, Size_T N, S alpha, const A *a, Size_T lda,
+        const X *x, Size_T incx, T beta, Y *y, Size_T incy) {
+    using R = decltype(A{} * X{});
+    Size_T grain = level2_grain / std::max<Size_T>(N, 1) + 1;
+    parallel_for(Size_T{0}, M, grain, [=](Size_T b, Size_T e) {
+        for (Size_T r = b; r < e; ++r) {
+            R cur = dot_serial<R>(N, a + r * lda, 1, x, incx);
+            Y &out = y[r * incy];
+            // beta == 0 must not read y, it may hold garbage
+            out = beta == T{} ? alpha * cur : alpha * cur + beta * out;
+        }
+    });
+}
+
+/// y = alpha * A^T * x + beta * y, A is M x N row-major with leading dim lda
+template<
+    typename S,
+    typename A,
+    typename X,
+    typename T,
+    typename Y>
+void gemv_t_kernel(Size_T M, Size_T N, S alpha, const A *a, Size_T lda,
+        const X *x, Size_T incx, T beta, Y *y, Size_T incy) {
+    Size_T grain = level2_grain / std::max<Size_T>(M, 1) + 1;
+    // split over the columns of A so every thread owns a piece of y
+    parallel_for(Size_T{0}, N, grain, [=](Size_T b, Size_T e) {
+        Y *yb = y + b * incy;
+        if (beta == T{}) {
+            for (Size_T c = 0; c < e - b; ++c) {
+                yb[c * incy] = Y{};
+            }
+        } else {
+            scal_serial(e - b, beta, yb, incy);
+        }
+        for (Size_T r = 0; r < M; ++r) {
+            axpy_serial(e - b, alpha * x[r * incx], a + r * lda + b, 1, yb, incy);
+        }
+    });
+}
+
+/// A = A + alpha * x * y^T, A is M x N row-major with leading dim lda
+template<
+    typename S,
+    typename X,
+    typename Y,
+    typename A>
+void ger_kernel(Size_T M, Size_T N, S alpha, const X *x, Size_T incx,
+        const Y *y, Size_T incy, A *a, Size_T lda) {
+    Size_T grain = level2_grain / std::max<Size_T>(N, 1) + 1;
+    parallel_for(Size_T{0}, M, grain, [=](Size_T b, Size_T e) {
+        for (Size_T r = b; r < e; ++r) {
+            axpy_serial(N, alpha * x[r * incx], y, incy, a + r * lda, 1);
+        }
+    });
+}
+
+/// C[0:mr, 0:nr] += alpha * A[0:mr, 0:K] * B[0:K, 0:nr] for one register
+/// tile, full tiles have compile-time bounds so the accumulators stay in
+/// registers
+template<
+    Size_T MR,
+    Size_T NR,
+    typename S,
+    typename A,
+    typename B,
+    typename C>
+void gemm_tile(Size_T mr, Size_T nr, Size_T K, S alpha, const A *a, Size_T lda,
+        const B *b, Size_T ldb, C *c, Size_T ldc) {
+    C acc[MR][NR] = {};
+    if (mr == MR && nr == NR) {
+        for (Size_T k = 0; k < K; ++k) {
+            const B *bk = b + k * ldb;
+            for (Size_T i = 0; i < MR; ++i) {
+                C aik = a[i * lda + k];
+                for (Size_T j = 0; j < NR; ++j) {
+                    acc[i][j] += aik * bk[j];
+                }
+            }
+        }
+    } else {
+        for (Size_T k = 0; k < K; ++k) {
+            const B *bk = b + k * ldb;
+            for (Size_T i = 0; i < mr; ++i) {
+                C aik = a[i * lda + k];
+                for (Size_T j = 0; j < nr; ++j) {
+                    acc[i][j] += aik * bk[j];
+                }
+            }
+        }
+    }
+    for (Size_T i = 0; i < mr; ++i) {
+        for (Size_T j = 0; j < nr; ++j) {
+            c[i * ldc + j] += alpha * acc[i][j];
+        }
+    }
+}
+
+/// C = alpha * A * B + beta * C, A is M x K, B is K x N, all row-major
+template<
+    typename S,
+    typename A,
+    typename B,
+    typename T,
+    typename C>
+void gemm_kernel(Size_T M, Size_T K, Size_T N, S alpha, const A *a, Size_T lda,
+        const B *b, Size_T ldb, T beta, C *c, Size_T ldc) {
+    Size_T grain = level3_grain / std::max<Size_T>(K * N, 1) + 1;
+    grain = (grain + gemm_mr - 1) / gemm_mr * gemm_mr;
+    parallel_for(Size_T{0}, M, grain, [=](Size_T rb, Size_T re) {
+        for (Size_T r = rb; r < re; ++r) {
+            // beta == 0 must not read C, it may hold garbage
+            if (beta == T{}) {
+                std::fill(c + r * ldc, c + r * ldc + N, C{});
+            } else if (beta != Default<T>::one) {
+                scal_serial(N, beta, c + r * ldc, 1);
+            }
+        }
+        for (Size_T jc = 0; jc < N; jc += gemm_nc) {
+            Size_T nb = std::min(gemm_nc, N - jc);
+            for (Size_T pc = 0; pc < K; pc += gemm_kc) {
+                Size_T kb = std::min(gemm_kc, K - pc);
+                for (Size_T i = rb; i < re; i += gemm_mr) {
+                    Size_T mr = std::min(gemm_mr, re - i);
+                    for (Size_T j = jc; j < jc + nb; j += gemm_nr) {
+                        gemm_tile<gemm_mr, gemm_nr>(mr, std::min(gemm_nr, jc + nb - j), kb, alpha,
+                            a + i * lda + pc, lda, b + pc * ldb + j, ldb, c + i * ldc + j, ldc);
+                    }
+                }
+            }
+        }
+    });
+}
+
+}
+
+
+/// level-1, level-2 and level-3 routines on Vector, VectorView and Matrix
+namespace matlib {
+
+template<typename> class Matrix;
+
+template<
+    typename X,
+    typename Y,
+    typename = std::enable_if_t<is_vector_v<X> && is_vector_v<Y>>>
+auto dot(const X &x, const Y &y) {
+    using Return_T = decltype(typename X::ValueType{} * typename Y::ValueType{});
+    MATLIB_CHECK(typename X::ValueType, Assert, x.size() == y.size(), "Size must match for dot product.");
+    return detail::dot_kernel<Return_T>(x.size(),
+        x.raw_data(), x.stride(), y.raw_data(), y.stride());
+}
+
+/// y = alpha * x + y
+template<
+    typename S,
+    typename X,
+    typename Y,
+    typename = std::enable_if_t<is_vector_v<X> && is_vector_v<Y>>>
+void axpy(S alpha, const X &x, Y &&y) {
+    MATLIB_CHECK(typename X::ValueType, Assert, x.size() == y.size(), "Size must match for axpy.");
+    detail::axpy_kernel(x.size(), alpha,
+        x.raw_data(), x.stride(), y.raw_data(), y.stride());
+}
+
+/// x = alpha * x
+template<
+    typename S,
+    typename X,
+    typename = std::enable_if_t<is_vector_v<X>>>
+void scal(S alpha, X &&x) {
+    detail::scal_kernel(x.size(), alpha, x.raw_data(), x.stride());
+}
+
+/// euclidean norm, safe against intermediate overflow and underflow
+template<
+    typename X,
+    typename = std::enable_if_t<is_vector_v<X>>>
+auto nrm2(const X &x) {
+    return detail::nrm2_kernel(x.size(), x.raw_data(), x.stride());
+}
+
+/// y = alpha * A * x + beta * y
+template<
+    typename S,
+    typename V,
+    typename X,
+    typename T,
+    typename Y,
+    typename = std::enable_if_t<is_vector_v<X> && is_vector_v<Y>>>
+void gemv(S alpha, const Matrix<V> &A, const X &x, T beta, Y &&y) {
+    auto shape = A.get_shape();
+    MATLIB_CHECK(V, Assert, shape.second == x.size() && shape.first == y.size(),
+        "Shape must match for gemv.");
+    detail::gemv_kernel(shape.first, shape.second, alpha, A.raw_data(), shape.second,
+        x.raw_data(), x.stride(), beta, y.raw_data(), y.stride());
+}
+
+/// y = alpha * A^T * x + beta * y
+template<
+    typename S,
+    typename V,
+    typename X,
+    typename T,
+    typename Y,
+    typename = std::enable_if_t<is_vector_v<X> && is_vector_v<Y>>>
+void gemv_t(S alpha, const Matrix<V> &A, const X &x, T beta, Y &&y) {
+    auto shape = A.get_shape();
+    MATLIB_CHECK(V, Assert, shape.first == x.size() && shape.second == y.size(),
+        "Shape must match for transposed gemv.");
+    detail::gemv_t_kernel(shape.first, shape.second, alpha, A.raw_data(), shape.second,
+        x.raw_data(), x.stride(), beta, y.raw_data(), y.stride());
+}
+
+/// A = A + alpha * x * y^T
+template<
+    typename S,
+    typename X,
+    typename Y,
+    typename V,
+    typename = std::enable_if_t<is_vector_v<X> && is_vector_v<Y>>>
+void ger(S alpha, const X &x, const Y &y, Matrix<V> &A) {
+    auto shape = A.get_shape();
+    MATLIB_CHECK(V, Assert, shape.first == x.size() && shape.second == y.size(),
+        "Shape must match for ger.");
+    detail::ger_kernel(shape.first, shape.second, alpha,
+        x.raw_data(), x.stride(), y.raw_data(), y.stride(), A.raw_data(), shape.second);
+}
+
+}
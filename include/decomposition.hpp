@@ -1,76 +1,415 @@
 #pragma once
 
 // std
+#include <algorithm>
+#include <cmath>
 #include <tuple>
 #include <numeric>
+#include <vector>
 // matlib
 #include "utility.hpp"
 #include "common.hpp"
+#include "reduction.hpp"
 
 
 namespace matlib {
 
 template<typename> class Matrix;
+template<typename> class Vector;
 
+namespace detail {
+
+/// row-pivoted elimination in place, multipliers are left below the
+/// pivots and permute[k] is the source row of row k
 template<typename V>
-std::tuple<Matrix<V>, Matrix<V>, Matrix<V>>
-PLU_decomposite(const Matrix<V> &mat) {
-    auto origin_shape = mat.get_shape();
-    Matrix<V> inplace = mat;
+void PLU_inplace(Matrix<V> &inplace, std::vector<Size_T> &permute) {
+    auto origin_shape = inplace.get_shape();
     // line rearange
-    std::vector<Size_T> permute (origin_shape.first);
+    permute.resize(origin_shape.first);
     std::iota(permute.begin(), permute.end(), 0);
     // prepare for loop
     Size_T i{}, j{};
     while (j < origin_shape.second) {
-        // find largest row index in columns
-        Size_T iM = origin_shape.first + 1;
-        V largest = Default<V>::zero;
-        for (Size_T k = i; k < origin_shape.first; ++k) {
-            if (std::abs(inplace.at(k, j)) > largest) {
-                largest = std::abs(inplace.at(k, j));
-                iM = k;
-            }
+        // no rows left to eliminate
+        if (i == origin_shape.first) {
+            break;
         }
+        // find largest row index in columns
+        Size_T iM = i + argmax_abs(inplace.col(j).slice(i, origin_shape.first - 1));
         // all zero column
-        if (iM == origin_shape.first + 1) {
+        if (!(std::abs(inplace.unsafe_at(iM, j)) > Default<V>::zero)) {
             ++j;
             continue;
         }
         // swap largest to current
         std::swap(permute[i], permute[iM]);
         for (Size_T k = 0; k < origin_shape.second; ++k) {
-            std::swap(inplace.at(i, k), inplace.at(iM, k));
+            std::swap(inplace.unsafe_at(i, k), inplace.unsafe_at(iM, k));
         }
         // process each row below
-        for (Size_T k = i + 1; k < origin_shape.first; ++k) {
-            V t = inplace.at(k, j) / inplace.at(i, j);
-            for (Size_T s = j + 1; s < origin_shape.second; ++s) {
-                inplace.at(k, s) = inplace.at(k, s) - t * inplace.at(i, s);
+        Size_T width = origin_shape.second - j - 1;
+        const V *pivot_row = &inplace.unsafe_at(i, j);
+        parallel_for(i + 1, origin_shape.first, level2_grain / (width + 1) + 1, [&](Size_T b, Size_T e) {
+            for (Size_T k = b; k < e; ++k) {
+                V *row = &inplace.unsafe_at(k, j);
+                V t = row[0] / pivot_row[0];
+                axpy_serial(width, -t, pivot_row + 1, 1, row + 1, 1);
+                row[0] = t;
             }
-            inplace.at(k, j) = t;
-        }
+        });
         ++j, ++i;
     }
+}
+
+/// panel widths of the blocked factorizations, wide enough that the
+/// trailing updates are dominated by gemm
+inline constexpr Size_T qr_block = 32;
+inline constexpr Size_T cholesky_block = 64;
+
+/// Householder reflector H = I - tau v v^T with H x = beta e_1, x is
+/// overwritten by beta followed by v[1:], v[0] = 1 is implicit
+template<typename T>
+void householder(Size_T n, T *x, Size_T inc, T &tau) {
+    tau = T{};
+    if (n < 2) {
+        return;
+    }
+    T alpha = x[0];
+    T xnorm = nrm2_kernel(n - 1, x + inc, inc);
+    if (xnorm == T{}) {
+        return;
+    }
+    T beta = -std::copysign(std::hypot(alpha, xnorm), alpha);
+    tau = (beta - alpha) / beta;
+    scal_serial(n - 1, Default<T>::one / (alpha - beta), x + inc, inc);
+    x[0] = beta;
+}
+
+/// unblocked QR of an m x nb panel, reflectors are left below the diagonal
+template<typename T>
+void qr_panel(Size_T m, Size_T nb, T *a, Size_T lda, T *tau, T *w) {
+    for (Size_T c = 0; c < nb && c < m; ++c) {
+        T *p = a + c * lda + c;
+        householder(m - c, p, lda, tau[c]);
+        Size_T rest = nb - c - 1;
+        if (tau[c] == T{} || rest == 0) {
+            continue;
+        }
+        // A[c:, c+1:] -= tau v (v^T A[c:, c+1:])
+        T beta = p[0];
+        p[0] = Default<T>::one;
+        gemv_t_kernel(m - c, rest, Default<T>::one, p + 1, lda, p, lda, T{}, w, 1);
+        ger_kernel(m - c, rest, -tau[c], p, lda, w, 1, p + 1, lda);
+        p[0] = beta;
+    }
+}
+
+/// expand the nb reflectors stored in an m x nb panel into explicit V
+/// (m x nb), V^T (nb x m) and the upper triangular T of the compact WY
+/// form H_0 H_1 ... H_{nb-1} = I - V T V^T
+template<typename T>
+void qr_block_reflector(Size_T m, Size_T nb, const T *a, Size_T lda, const T *tau,
+        T *v, T *vt, T *t) {
+    for (Size_T r = 0; r < m; ++r) {
+        for (Size_T c = 0; c < nb; ++c) {
+            T e = r > c ? a[r * lda + c] : (r == c ? Default<T>::one : T{});
+            v[r * nb + c] = e;
+            vt[c * m + r] = e;
+        }
+    }
+    std::fill(t, t + nb * nb, T{});
+    std::vector<T> z (nb);
+    for (Size_T i = 0; i < nb; ++i) {
+        t[i * nb + i] = tau[i];
+        if (i == 0 || tau[i] == T{}) {
+            continue;
+        }
+        // T[0:i, i] = -tau_i T[0:i, 0:i] V[:, 0:i]^T v_i, v_i is zero above row i
+        gemv_t_kernel(m - i, i, -tau[i], v + i * nb, nb, v + i * nb + i, nb, T{}, z.data(), 1);
+        for (Size_T r = 0; r < i; ++r) {
+            t[r * nb + i] = dot_serial<T>(i - r, t + r * nb + r, 1, z.data() + r, 1);
+        }
+    }
+}
+
+/// C = (I - V T V^T) C, or (I - V T^T V^T) C when `transpose`; C is m x n
+/// and W is nb x n scratch. Both products with V run through gemm.
+template<typename T>
+void qr_apply_block(Size_T m, Size_T nb, Size_T n, const T *v, const T *vt, const T *t,
+        T *c, Size_T ldc, bool transpose, T *w) {
+    if (n == 0) {
+        return;
+    }
+    gemm_kernel(nb, m, n, Default<T>::one, vt, m, c, ldc, T{}, w, n);
+    // W = T W or T^T W in place, T is upper triangular
+    if (transpose) {
+        for (Size_T i = nb; i-- > 0;) {
+            scal_serial(n, t[i * nb + i], w + i * n, 1);
+            for (Size_T k = 0; k < i; ++k) {
+                axpy_serial(n, t[k * nb + i], w + k * n, 1, w + i * n, 1);
+            }
+        }
+    } else {
+        for (Size_T i = 0; i < nb; ++i) {
+            scal_serial(n, t[i * nb + i], w + i * n, 1);
+            for (Size_T k = i + 1; k < nb; ++k) {
+                axpy_serial(n, t[i * nb + k], w + k * n, 1, w + i * n, 1);
+            }
+        }
+    }
+    gemm_kernel(m, nb, n, -Default<T>::one, v, nb, w, n, Default<T>::one, c, ldc);
+}
+
+/// blocked Householder QR in place, R is left on and above the diagonal
+/// and the reflectors below it, tau gets min(m, n) entries
+///
+/// Each panel of qr_block columns is factored with level-2 kernels, then
+/// its reflectors are aggregated into I - V T V^T and applied to the
+/// trailing columns with two gemm calls.
+template<typename V>
+void QR_inplace(Matrix<V> &inplace, std::vector<V> &tau) {
+    auto [m, n] = inplace.get_shape();
+    Size_T k = std::min(m, n);
+    tau.assign(k, V{});
+    V *a = inplace.raw_data();
+    std::vector<V> v, vt, t, w;
+    for (Size_T j = 0; j < k; j += qr_block) {
+        Size_T jb = std::min(qr_block, k - j), mj = m - j, rest = n - j - jb;
+        w.resize(std::max(jb, qr_block) * std::max<Size_T>(rest, qr_block));
+        qr_panel(mj, jb, a + j * n + j, n, tau.data() + j, w.data());
+        if (rest == 0) {
+            continue;
+        }
+        v.resize(mj * jb), vt.resize(mj * jb), t.resize(jb * jb);
+        qr_block_reflector(mj, jb, a + j * n + j, n, tau.data() + j, v.data(), vt.data(), t.data());
+        qr_apply_block(mj, jb, rest, v.data(), vt.data(), t.data(),
+            a + j * n + j + jb, n, true, w.data());
+    }
+}
+
+/// B = Q^T B for the factors left by QR_inplace, B has as many rows as A
+template<typename V>
+void QR_apply_qt(const Matrix<V> &factor, const std::vector<V> &tau, Matrix<V> &b) {
+    auto [m, n] = factor.get_shape();
+    Size_T k = tau.size(), nrhs = b.get_shape().second;
+    std::vector<V> v, vt, t, w (qr_block * nrhs);
+    for (Size_T j = 0; j < k; j += qr_block) {
+        Size_T jb = std::min(qr_block, k - j), mj = m - j;
+        v.resize(mj * jb), vt.resize(mj * jb), t.resize(jb * jb);
+        qr_block_reflector(mj, jb, factor.raw_data() + j * n + j, n, tau.data() + j,
+            v.data(), vt.data(), t.data());
+        qr_apply_block(mj, jb, nrhs, v.data(), vt.data(), t.data(),
+            b.raw_data() + j * nrhs, nrhs, true, w.data());
+    }
+}
+
+/// blocked Cholesky A = L L^T in place, only the lower triangle is read or
+/// written; false when A is not numerically positive definite
+///
+/// Right-looking: factor a diagonal block, solve the panel below it, then
+/// update the trailing lower triangle. The part of each trailing block row
+/// left of the diagonal goes through gemm, the diagonal block itself
+/// through dot products so the upper triangle is never touched.
+template<typename V>
+bool cholesky_inplace(Matrix<V> &inplace) {
+    Size_T n = inplace.get_shape().first;
+    V *a = inplace.raw_data();
+    std::vector<V> panel_t;
+    for (Size_T k = 0; k < n; k += cholesky_block) {
+        Size_T kb = std::min(cholesky_block, n - k), below = n - k - kb;
+        // diagonal block
+        for (Size_T i = k; i < k + kb; ++i) {
+            V *ri = a + i * n;
+            for (Size_T j = k; j <= i; ++j) {
+                V s = ri[j] - dot_serial<V>(j - k, ri + k, 1, a + j * n + k, 1);
+                if (j < i) {
+                    ri[j] = s / a[j * n + j];
+                } else if (s > V{}) {
+                    ri[i] = std::sqrt(s);
+                } else {
+                    return false;
+                }
+            }
+        }
+        if (below == 0) {
+            break;
+        }
+        // panel, L_21 = A_21 L_11^{-T} row by row
+        parallel_for(k + kb, n, level2_grain / (kb * kb) + 1, [=](Size_T b, Size_T e) {
+            for (Size_T i = b; i < e; ++i) {
+                V *ri = a + i * n;
+                for (Size_T j = k; j < k + kb; ++j) {
+                    ri[j] = (ri[j] - dot_serial<V>(j - k, ri + k, 1, a + j * n + k, 1)) / a[j * n + j];
+                }
+            }
+        });
+        // trailing lower triangle, A_22 -= L_21 L_21^T
+        panel_t.resize(kb * below);
+        for (Size_T i = 0; i < below; ++i) {
+            for (Size_T j = 0; j < kb; ++j) {
+                panel_t[j * below + i] = a[(k + kb + i) * n + k + j];
+            }
+        }
+        for (Size_T ib = k + kb; ib < n; ib += cholesky_block) {
+            Size_T ie = std::min(ib + cholesky_block, n);
+            gemm_kernel(ie - ib, kb, ib - k - kb, -Default<V>::one, a + ib * n + k, n,
+                panel_t.data(), below, Default<V>::one, a + ib * n + k + kb, n);
+            for (Size_T i = ib; i < ie; ++i) {
+                for (Size_T j = ib; j <= i; ++j) {
+                    a[i * n + j] -= dot_serial<V>(kb, a + i * n + k, 1, a + j * n + k, 1);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+template<typename V>
+std::tuple<Matrix<V>, Matrix<V>, Matrix<V>>
+PLU_decomposite(const Matrix<V> &mat) {
+    auto origin_shape = mat.get_shape();
+    Matrix<V> inplace = mat;
+    std::vector<Size_T> permute;
+    detail::PLU_inplace(inplace, permute);
     // process output
     Matrix<V> P_mat(origin_shape.first, origin_shape.first),
         L_mat(origin_shape.first, origin_shape.first),
         U_mat(origin_shape);
     for (Size_T i = 0; i < origin_shape.first; ++i) {
         for (Size_T j = 1; j <= i; ++j) {
-            L_mat.at(i, j - 1) = inplace.at(i, j - 1);
+            L_mat.unsafe_at(i, j - 1) = inplace.unsafe_at(i, j - 1);
         }
-        L_mat.at(i, i) = 1;
+        L_mat.unsafe_at(i, i) = 1;
     }
     for (Size_T i = 0; i < origin_shape.first; ++i) {
         for (Size_T j = i; j < origin_shape.second; ++j) {
-            U_mat.at(i, j) = inplace.at(i, j);
+            U_mat.unsafe_at(i, j) = inplace.unsafe_at(i, j);
         }
     }
     for (Size_T k = 0; k < origin_shape.first; ++k) {
-        P_mat.at(k, permute[k]) = Default<V>::one;
+        P_mat.unsafe_at(k, permute[k]) = Default<V>::one;
     }
     return {P_mat, L_mat, U_mat};
 }
 
-}
\ No newline at end of file
+/// thin QR, A (m x n) = Q R with Q m x min(m, n) having orthonormal
+/// columns and R min(m, n) x n upper trapezoidal
+template<typename V>
+std::tuple<Matrix<V>, Matrix<V>>
+QR_decomposite(const Matrix<V> &mat) {
+    auto [m, n] = mat.get_shape();
+    Size_T k = std::min(m, n);
+    Matrix<V> inplace = mat;
+    std::vector<V> tau;
+    detail::QR_inplace(inplace, tau);
+    Matrix<V> R_mat (k, n);
+    for (Size_T i = 0; i < k; ++i) {
+        for (Size_T j = i; j < n; ++j) {
+            R_mat.unsafe_at(i, j) = inplace.unsafe_at(i, j);
+        }
+    }
+    // Q = H_0 ... H_{k-1} [I; 0], applied block by block from the back
+    Matrix<V> Q_mat (m, k);
+    for (Size_T i = 0; i < k; ++i) {
+        Q_mat.unsafe_at(i, i) = Default<V>::one;
+    }
+    std::vector<V> v, vt, t, w (detail::qr_block * k);
+    for (Size_T blk = (k + detail::qr_block - 1) / detail::qr_block; blk-- > 0;) {
+        Size_T j = blk * detail::qr_block;
+        Size_T jb = std::min(detail::qr_block, k - j), mj = m - j;
+        v.resize(mj * jb), vt.resize(mj * jb), t.resize(jb * jb);
+        detail::qr_block_reflector(mj, jb, inplace.raw_data() + j * n + j, n, tau.data() + j,
+            v.data(), vt.data(), t.data());
+        // columns left of j are still e_i and untouched by these reflectors
+        detail::qr_apply_block(mj, jb, k - j, v.data(), vt.data(), t.data(),
+            Q_mat.raw_data() + j * k + j, k, false, w.data());
+    }
+    return {Q_mat, R_mat};
+}
+
+/// lower triangular L with A = L L^T, only the lower triangle of A is read
+template<typename V>
+Matrix<V> cholesky_decomposite(const Matrix<V> &mat) {
+    MATLIB_CHECK(V, Assert, mat.get_shape().first == mat.get_shape().second,
+        "Cholesky needs a square matrix.");
+    Matrix<V> retval = mat;
+    ASSERT_MSG(detail::cholesky_inplace(retval), "Matrix is not positive definite.");
+    Size_T n = mat.get_shape().first;
+    for (Size_T i = 0; i < n; ++i) {
+        std::fill(retval.raw_data() + i * n + i + 1, retval.raw_data() + (i + 1) * n, V{});
+    }
+    return retval;
+}
+
+/// X minimizing |A X - B|_F through Householder QR, A is m x n with m >= n
+/// and full column rank
+template<typename V>
+Matrix<V> least_squares(const Matrix<V> &A, const Matrix<V> &B) {
+    auto [m, n] = A.get_shape();
+    MATLIB_CHECK(V, Assert, m >= n, "Least squares needs at least as many rows as columns.");
+    MATLIB_CHECK(V, Assert, B.get_shape().first == m, "Shape must match for least squares.");
+    Size_T nrhs = B.get_shape().second;
+    Matrix<V> factor = A, rhs = B;
+    std::vector<V> tau;
+    detail::QR_inplace(factor, tau);
+    detail::QR_apply_qt(factor, tau, rhs);
+    // back substitution R X = (Q^T B)[0:n]
+    Matrix<V> retval (n, nrhs);
+    std::copy(rhs.raw_data(), rhs.raw_data() + n * nrhs, retval.raw_data());
+    V *x = retval.raw_data();
+    for (Size_T i = n; i-- > 0;) {
+        V rii = factor.unsafe_at(i, i);
+        ASSERT_MSG(rii != V{}, "Matrix is rank deficient.");
+        for (Size_T k = i + 1; k < n; ++k) {
+            detail::axpy_serial(nrhs, -factor.unsafe_at(i, k), x + k * nrhs, 1, x + i * nrhs, 1);
+        }
+        detail::scal_serial(nrhs, Default<V>::one / rii, x + i * nrhs, 1);
+    }
+    return retval;
+}
+
+template<typename V>
+Vector<V> least_squares(const Matrix<V> &A, const Vector<V> &b) {
+    auto x = least_squares(A, b.to_mat());
+    return Vector<V>(x.get_shape().first, x.raw_data());
+}
+
+/// X = A^{-1} B for symmetric positive definite A through Cholesky, only
+/// the lower triangle of A is read
+template<typename V>
+Matrix<V> spd_solve(const Matrix<V> &A, const Matrix<V> &B) {
+    MATLIB_CHECK(V, Assert, A.get_shape().first == A.get_shape().second,
+        "SPD solve needs a square matrix.");
+    MATLIB_CHECK(V, Assert, B.get_shape().first == A.get_shape().first,
+        "Shape must match for solve.");
+    Size_T n = A.get_shape().first, nrhs = B.get_shape().second;
+    Matrix<V> factor = A, retval = B;
+    ASSERT_MSG(detail::cholesky_inplace(factor), "Matrix is not positive definite.");
+    const V *l = factor.raw_data();
+    V *x = retval.raw_data();
+    // L Y = B
+    for (Size_T i = 0; i < n; ++i) {
+        for (Size_T k = 0; k < i; ++k) {
+            detail::axpy_serial(nrhs, -l[i * n + k], x + k * nrhs, 1, x + i * nrhs, 1);
+        }
+        detail::scal_serial(nrhs, Default<V>::one / l[i * n + i], x + i * nrhs, 1);
+    }
+    // L^T X = Y, column i of L is row i of L^T
+    for (Size_T i = n; i-- > 0;) {
+        detail::scal_serial(nrhs, Default<V>::one / l[i * n + i], x + i * nrhs, 1);
+        for (Size_T k = 0; k < i; ++k) {
+            detail::axpy_serial(nrhs, -l[i * n + k], x + i * nrhs, 1, x + k * nrhs, 1);
+        }
+    }
+    return retval;
+}
+
+template<typename V>
+Vector<V> spd_solve(const Matrix<V> &A, const Vector<V> &b) {
+    auto x = spd_solve(A, b.to_mat());
+    return Vector<V>(x.get_shape().first, x.raw_data());
+}
+
+}
@@ -0,0 +1,408 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+// matlib
+#include "common.hpp"
+#include "utility.hpp"
+#include "parallel.hpp"
+
+
+/// text parsing and formatting helpers
+///
+/// Input is split into line-aligned chunks that are parsed concurrently.
+/// Every chunk first counts its records, a prefix sum gives each chunk its
+/// first destination row, then all chunks parse straight into the storage
+/// of the result matrix.
+namespace matlib::detail {
+
+// minimum bytes per parsing chunk
+inline constexpr Size_T io_grain = Size_T{1} << 20;
+// rows formatted per output chunk
+inline constexpr Size_T io_rows_per_chunk = 256;
+
+inline std::string read_file(const std::string &path) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    ASSERT_MSG(file != nullptr, "Cannot open file for reading.");
+    std::fseek(file, 0, SEEK_END);
+    long length = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    std::string retval (length > 0 ? static_cast<Size_T>(length) : 0, '\0');
+    Size_T got = std::fread(retval.data(), 1, retval.size(), file);
+    std::fclose(file);
+    ASSERT_MSG(got == retval.size(), "Short read.");
+    return retval;
+}
+
+inline void write_file(const std::string &path, const std::vector<std::string> &pieces) {
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    ASSERT_MSG(file != nullptr, "Cannot open file for writing.");
+    for (const auto &piece : pieces) {
+        Size_T put = std::fwrite(piece.data(), 1, piece.size(), file);
+        ASSERT_MSG(put == piece.size(), "Short write.");
+    }
+    ASSERT_MSG(std::fclose(file) == 0, "Cannot close file.");
+}
+
+inline const char *line_end(const char *p, const char *end) {
+    auto q = static_cast<const char *>(std::memchr(p, '\n', static_cast<Size_T>(end - p)));
+    return q == nullptr ? end : q;
+}
+
+inline const char *skip_blank(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+/// a line carries a record unless it is blank or starts with `comment`
+inline bool is_record(const char *p, const char *eol, char comment) {
+    p = skip_blank(p, eol);
+    return p < eol && *p != comment;
+}
+
+/// boundaries of `chunks` pieces of [begin, end), each starting a line
+inline std::vector<const char *> split_lines(const char *begin, const char *end, Size_T chunks) {
+    std::vector<const char *> bounds {begin};
+    Size_T total = static_cast<Size_T>(end - begin);
+    for (Size_T t = 1; t < chunks; ++t) {
+        const char *p = begin + total * t / chunks;
+        p = std::max(p, bounds.back());
+        p = line_end(p, end);
+        bounds.push_back(p == end ? end : p + 1);
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+/// run f(chunk, chunk_begin, chunk_end) on every chunk concurrently
+template<typename F>
+void for_each_chunk(const std::vector<const char *> &bounds, F &&f) {
+    parallel_for(Size_T{0}, bounds.size() - 1, 1, [&](Size_T b, Size_T e) {
+        for (Size_T t = b; t < e; ++t) {
+            f(t, bounds[t], bounds[t + 1]);
+        }
+    });
+}
+
+/// split [begin, end) and count the records of every chunk, returns the
+/// chunk bounds and the index of the first record of every chunk
+inline std::pair<std::vector<const char *>, std::vector<Size_T>>
+index_records(const char *begin, const char *end, char comment) {
+    Size_T chunks = chunk_count(static_cast<Size_T>(end - begin), io_grain);
+    auto bounds = split_lines(begin, end, chunks);
+    std::vector<Size_T> first (bounds.size(), 0);
+    for_each_chunk(bounds, [&](Size_T t, const char *p, const char *e) {
+        Size_T count = 0;
+        while (p < e) {
+            const char *eol = line_end(p, e);
+            count += is_record(p, eol, comment);
+            p = eol + 1;
+        }
+        first[t + 1] = count;
+    });
+    for (Size_T t = 1; t < first.size(); ++t) {
+        first[t] += first[t - 1];
+    }
+    return {bounds, first};
+}
+
+template<typename V>
+const char *parse_value(const char *p, const char *end, V &out) {
+    p = skip_blank(p, end);
+    // from_chars rejects an explicit plus sign
+    if (p < end && *p == '+') {
+        ++p;
+    }
+    auto [next, ec] = std::from_chars(p, end, out);
+    ASSERT_MSG(ec == std::errc() && next != p, "Malformed number.");
+    return next;
+}
+
+template<typename V>
+void format_value(std::string &out, V value) {
+    char buffer[64];
+    auto [next, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    ASSERT_MSG(ec == std::errc(), "Cannot format number.");
+    out.append(buffer, next);
+}
+
+/// format rows [0, rows) in parallel, f(string &, row) appends one row
+template<typename F>
+std::vector<std::string> format_rows(Size_T rows, F &&f) {
+    Size_T pieces = (rows + io_rows_per_chunk - 1) / io_rows_per_chunk;
+    std::vector<std::string> retval (pieces);
+    parallel_for(Size_T{0}, pieces, 1, [&](Size_T b, Size_T e) {
+        for (Size_T t = b; t < e; ++t) {
+            Size_T last = std::min(rows, (t + 1) * io_rows_per_chunk);
+            for (Size_T r = t * io_rows_per_chunk; r < last; ++r) {
+                f(retval[t], r);
+            }
+        }
+    });
+    return retval;
+}
+
+inline bool iequal(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+        [](char x, char y) { return std::tolower(x) == std::tolower(y); });
+}
+
+}
+
+
+/// dense CSV
+namespace matlib {
+
+template<typename> class Matrix;
+
+/// parse comma (or `delimiter`) separated values, one matrix row per line,
+/// blank lines are skipped
+template<typename V>
+Matrix<V> parse_csv(std::string_view text, char delimiter = ',') {
+    const char *begin = text.data(), *end = text.data() + text.size();
+    // the first record fixes the number of columns
+    const char *p = begin;
+    while (p < end && !detail::is_record(p, detail::line_end(p, end), '\0')) {
+        p = detail::line_end(p, end) + 1;
+    }
+    if (p >= end) {
+        return Matrix<V>(0, 0);
+    }
+    const char *eol = detail::line_end(p, end);
+    Size_T NC = 1 + static_cast<Size_T>(std::count(p, eol, delimiter));
+
+    // named references, lambdas cannot capture structured bindings in C++17
+    auto index = detail::index_records(p, end, '\0');
+    const auto &bounds = index.first;
+    const auto &first = index.second;
+    Matrix<V> retval (first.back(), NC);
+    V *out = retval.raw_data();
+    detail::for_each_chunk(bounds, [&](Size_T t, const char *q, const char *e) {
+        V *row = out + first[t] * NC;
+        while (q < e) {
+            const char *line_eol = detail::line_end(q, e);
+            if (detail::is_record(q, line_eol, '\0')) {
+                for (Size_T c = 0; c < NC; ++c) {
+                    q = detail::parse_value(q, line_eol, row[c]);
+                    q = detail::skip_blank(q, line_eol);
+                    if (c + 1 < NC) {
+                        ASSERT_MSG(q < line_eol && *q == delimiter, "Too few columns in CSV row.");
+                        ++q;
+                    }
+                }
+                ASSERT_MSG(q == line_eol, "Too many columns in CSV row.");
+                row += NC;
+            }
+            q = line_eol + 1;
+        }
+    });
+    return retval;
+}
+
+template<typename V>
+Matrix<V> read_csv(const std::string &path, char delimiter = ',') {
+    std::string text = detail::read_file(path);
+    return parse_csv<V>(text, delimiter);
+}
+
+template<typename V>
+void write_csv(const std::string &path, const Matrix<V> &mat, char delimiter = ',') {
+    auto shape = mat.get_shape();
+    const V *data = mat.raw_data();
+    auto pieces = detail::format_rows(shape.first, [&](std::string &out, Size_T r) {
+        for (Size_T c = 0; c < shape.second; ++c) {
+            if (c > 0) {
+                out.push_back(delimiter);
+            }
+            detail::format_value(out, data[r * shape.second + c]);
+        }
+        out.push_back('\n');
+    });
+    detail::write_file(path, pieces);
+}
+
+}
+
+
+/// Matrix Market, https://math.nist.gov/MatrixMarket/formats.html
+namespace matlib {
+
+enum class MMFormat {
+    Coordinate,
+    Array,
+};
+
+/// parse a real, integer or pattern Matrix Market file into a dense matrix,
+/// general, symmetric and skew-symmetric storage are expanded; repeated
+/// coordinate entries keep one of the values
+template<typename V>
+Matrix<V> parse_matrix_market(std::string_view text) {
+    const char *begin = text.data(), *end = text.data() + text.size();
+
+    // banner
+    const char *eol = detail::line_end(begin, end);
+    std::vector<std::string_view> banner;
+    for (const char *p = begin; p < eol;) {
+        p = detail::skip_blank(p, eol);
+        const char *q = p;
+        while (q < eol && *q != ' ' && *q != '\t' && *q != '\r') {
+            ++q;
+        }
+        if (q > p) {
+            banner.emplace_back(p, static_cast<Size_T>(q - p));
+        }
+        p = q;
+    }
+    ASSERT_MSG(banner.size() == 5 && detail::iequal(banner[0], "%%MatrixMarket")
+        && detail::iequal(banner[1], "matrix"), "Bad Matrix Market banner.");
+    bool coordinate = detail::iequal(banner[2], "coordinate");
+    ASSERT_MSG(coordinate || detail::iequal(banner[2], "array"), "Unknown Matrix Market format.");
+    bool pattern = detail::iequal(banner[3], "pattern");
+    ASSERT_MSG(pattern || detail::iequal(banner[3], "real") || detail::iequal(banner[3], "integer")
+        || detail::iequal(banner[3], "double"), "Unsupported Matrix Market field.");
+    ASSERT_MSG(!(pattern && !coordinate), "Pattern field needs coordinate format.");
+    bool symmetric = detail::iequal(banner[4], "symmetric");
+    bool skew = detail::iequal(banner[4], "skew-symmetric");
+    ASSERT_MSG(symmetric || skew || detail::iequal(banner[4], "general"),
+        "Unsupported Matrix Market symmetry.");
+
+    // size line, after the comments
+    const char *p = eol + 1;
+    while (p < end && !detail::is_record(p, detail::line_end(p, end), '%')) {
+        p = detail::line_end(p, end) + 1;
+    }
+    ASSERT_MSG(p < end, "Missing Matrix Market size line.");
+    eol = detail::line_end(p, end);
+    Size_T NR{}, NC{}, entries{};
+    p = detail::parse_value(p, eol, NR);
+    p = detail::parse_value(p, eol, NC);
+    if (coordinate) {
+        p = detail::parse_value(p, eol, entries);
+    } else if (symmetric || skew) {
+        ASSERT_MSG(NR == NC, "Symmetric matrix must be square.");
+        entries = skew ? NR * (NR - (NR > 0)) / 2 : NR * (NR + 1) / 2;
+    } else {
+        entries = NR * NC;
+    }
+    ASSERT_MSG(detail::skip_blank(p, eol) == eol, "Bad Matrix Market size line.");
+
+    const char *body = std::min(eol + 1, end);
+    auto index = detail::index_records(body, end, '%');
+    const auto &bounds = index.first;
+    const auto &first = index.second;
+    ASSERT_MSG(first.back() == entries, "Matrix Market entry count mismatch.");
+    Matrix<V> retval (NR, NC);
+    V *out = retval.raw_data();
+
+    detail::for_each_chunk(bounds, [&](Size_T t, const char *q, const char *e) {
+        // array storage is column-major, lower triangle only when symmetric
+        Size_T i = 0, j = 0;
+        if (!coordinate) {
+            Size_T k = first[t];
+            Size_T skip = skew ? 1 : 0;
+            while (j < NC) {
+                Size_T col_len = (symmetric || skew) ? NR - j - skip : NR;
+                if (k < col_len) {
+                    break;
+                }
+                k -= col_len;
+                ++j;
+            }
+            i = (symmetric || skew) ? j + skip + k : k;
+        }
+        while (q < e) {
+            const char *line_eol = detail::line_end(q, e);
+            if (detail::is_record(q, line_eol, '%')) {
+                V value = Default<V>::one;
+                if (coordinate) {
+                    Size_T r{}, c{};
+                    q = detail::parse_value(q, line_eol, r);
+                    q = detail::parse_value(q, line_eol, c);
+                    ASSERT_MSG(r >= 1 && r <= NR && c >= 1 && c <= NC, "Matrix Market entry out of range.");
+                    i = r - 1, j = c - 1;
+                }
+                if (!pattern) {
+                    q = detail::parse_value(q, line_eol, value);
+                }
+                ASSERT_MSG(detail::skip_blank(q, line_eol) == line_eol, "Trailing data in Matrix Market entry.");
+                out[i * NC + j] = value;
+                if (symmetric && i != j) {
+                    out[j * NC + i] = value;
+                } else if (skew) {
+                    out[j * NC + i] = -value;
+                }
+                if (!coordinate && ++i == NR) {
+                    ++j;
+                    i = symmetric ? j : skew ? j + 1 : 0;
+                }
+            }
+            q = line_eol + 1;
+        }
+    });
+    return retval;
+}
+
+template<typename V>
+Matrix<V> read_matrix_market(const std::string &path) {
+    std::string text = detail::read_file(path);
+    return parse_matrix_market<V>(text);
+}
+
+/// write as a general real (or integer) matrix, coordinate format keeps
+/// only the nonzero entries
+template<typename V>
+void write_matrix_market(const std::string &path, const Matrix<V> &mat,
+        MMFormat format = MMFormat::Coordinate) {
+    auto shape = mat.get_shape();
+    const V *data = mat.raw_data();
+    std::vector<std::string> pieces;
+    std::string header = "%%MatrixMarket matrix ";
+    header += format == MMFormat::Coordinate ? "coordinate " : "array ";
+    header += std::is_integral_v<V> ? "integer general\n" : "real general\n";
+
+    if (format == MMFormat::Array) {
+        // column-major, a "row" of output is a column of the matrix
+        pieces = detail::format_rows(shape.second, [&](std::string &out, Size_T c) {
+            for (Size_T r = 0; r < shape.first; ++r) {
+                detail::format_value(out, data[r * shape.second + c]);
+                out.push_back('\n');
+            }
+        });
+        header += std::to_string(shape.first) + " " + std::to_string(shape.second) + "\n";
+    } else {
+        pieces = detail::format_rows(shape.first, [&](std::string &out, Size_T r) {
+            for (Size_T c = 0; c < shape.second; ++c) {
+                V value = data[r * shape.second + c];
+                if (value != Default<V>::zero) {
+                    detail::format_value(out, r + 1);
+                    out.push_back(' ');
+                    detail::format_value(out, c + 1);
+                    out.push_back(' ');
+                    detail::format_value(out, value);
+                    out.push_back('\n');
+                }
+            }
+        });
+        Size_T nnz = 0;
+        for (const auto &piece : pieces) {
+            nnz += static_cast<Size_T>(std::count(piece.begin(), piece.end(), '\n'));
+        }
+        header += std::to_string(shape.first) + " " + std::to_string(shape.second) + " "
+            + std::to_string(nnz) + "\n";
+    }
+    pieces.insert(pieces.begin(), header);
+    detail::write_file(path, pieces);
+}
+
+}
@@ -0,0 +1,394 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+// matlib
+#include "common.hpp"
+#include "utility.hpp"
+#include "blas.hpp"
+#include "reduction.hpp"
+#include "decomposition.hpp"
+
+
+namespace matlib {
+
+template<typename> class Matrix;
+template<typename> class Vector;
+
+/// UpdatableLU, a PA = LU factorization of a square matrix that follows
+/// low-rank changes in O(n^2) each instead of refactoring at O(n^3)
+///
+/// Rank-1 changes use Bennett's update of L and U, rank-k changes and row
+/// or column replacements are sequences of rank-1 changes. Appending grows
+/// the matrix by a bordered row and column; removing an index turns its
+/// row and column into those of the identity so it decouples from the
+/// rest, and the storage is compacted at the next refactorization.
+///
+/// Bennett's update does not pivot, so after every change the backward
+/// error of a fixed probe solve is measured; once it exceeds the drift
+/// tolerance the factorization is recomputed from the tracked matrix.
+template<typename V>
+class UpdatableLU {
+// methods
+public:
+    // construct
+    explicit UpdatableLU(const Matrix<V> &, V = default_tolerance());
+    // access
+    Size_T size() const;
+    Matrix<V> matrix() const;
+    V drift() const;
+    V drift_tolerance() const;
+    void set_drift_tolerance(V);
+    Size_T refactor_count() const;
+    // solve
+    Vector<V> solve(const Vector<V> &) const;
+    // updates
+    void rank_one_update(const Vector<V> &, const Vector<V> &);
+    void rank_k_update(const Matrix<V> &, const Matrix<V> &);
+    void replace_row(Size_T, const Vector<V> &);
+    void replace_col(Size_T, const Vector<V> &);
+    void append(const Vector<V> &, const Vector<V> &, V);
+    void remove(Size_T);
+    void refactor();
+
+    static V default_tolerance();
+
+// internal
+private:
+    void bennett(std::vector<V> &, std::vector<V> &);
+    void solve_physical(const V *, V *) const;
+    V probe_drift() const;
+    void monitor();
+
+private:
+    // physical matrix, removed indices hold identity rows and columns
+    Matrix<V> a;
+    // unit lower L below the diagonal, U on and above it
+    Matrix<V> lu;
+    std::vector<Size_T> permute;
+    // logical index -> physical index
+    std::vector<Size_T> active;
+    V tolerance;
+    V last_drift{};
+    Size_T refactors{};
+};
+
+}
+
+
+/// ======================================
+/// implementation
+
+namespace matlib {
+
+template<typename V>
+V UpdatableLU<V>::default_tolerance() {
+    // refactor once half of the significant digits are gone
+    return std::sqrt(std::numeric_limits<V>::epsilon());
+}
+
+template<typename V>
+UpdatableLU<V>::UpdatableLU(const Matrix<V> &mat, V tolerance_)
+    : a(mat), lu(mat), tolerance(tolerance_)
+{
+    MATLIB_CHECK(V, Assert, mat.get_shape().first == mat.get_shape().second,
+        "Updatable LU needs a square matrix.");
+    active.resize(mat.get_shape().first);
+    std::iota(active.begin(), active.end(), 0);
+    detail::PLU_inplace(lu, permute);
+    last_drift = probe_drift();
+}
+
+template<typename V>
+Size_T UpdatableLU<V>::size() const {
+    return active.size();
+}
+
+template<typename V>
+Matrix<V> UpdatableLU<V>::matrix() const {
+    Size_T n = active.size();
+    Matrix<V> retval (n, n);
+    for (Size_T i = 0; i < n; ++i) {
+        for (Size_T j = 0; j < n; ++j) {
+            retval.unsafe_at(i, j) = a.unsafe_at(active[i], active[j]);
+        }
+    }
+    return retval;
+}
+
+template<typename V>
+V UpdatableLU<V>::drift() const {
+    return last_drift;
+}
+
+template<typename V>
+V UpdatableLU<V>::drift_tolerance() const {
+    return tolerance;
+}
+
+template<typename V>
+void UpdatableLU<V>::set_drift_tolerance(V tolerance_) {
+    tolerance = tolerance_;
+}
+
+template<typename V>
+Size_T UpdatableLU<V>::refactor_count() const {
+    return refactors;
+}
+
+template<typename V>
+Vector<V> UpdatableLU<V>::solve(const Vector<V> &b) const {
+    MATLIB_CHECK(V, Assert, b.size() == active.size(), "Size must match for solve.");
+    Size_T N = a.get_shape().first;
+    std::vector<V> rhs (N, V{}), x (N);
+    for (Size_T i = 0; i < active.size(); ++i) {
+        rhs[active[i]] = b.unsafe_at(i);
+    }
+    solve_physical(rhs.data(), x.data());
+    Vector<V> retval (active.size());
+    for (Size_T i = 0; i < active.size(); ++i) {
+        retval.unsafe_at(i) = x[active[i]];
+    }
+    return retval;
+}
+
+/// A = A + x * y^T
+template<typename V>
+void UpdatableLU<V>::rank_one_update(const Vector<V> &x, const Vector<V> &y) {
+    MATLIB_CHECK(V, Assert, x.size() == active.size() && y.size() == active.size(),
+        "Size must match for rank-1 update.");
+    Size_T N = a.get_shape().first;
+    std::vector<V> px (N, V{}), py (N, V{});
+    for (Size_T i = 0; i < active.size(); ++i) {
+        px[active[i]] = x.unsafe_at(i);
+        py[active[i]] = y.unsafe_at(i);
+    }
+    detail::ger_kernel(N, N, Default<V>::one, px.data(), 1, py.data(), 1, a.raw_data(), N);
+    bennett(px, py);
+    monitor();
+}
+
+/// A = A + X * Y^T, X and Y are n x k
+template<typename V>
+void UpdatableLU<V>::rank_k_update(const Matrix<V> &X, const Matrix<V> &Y) {
+    MATLIB_CHECK(V, Assert, X.get_shape() == Y.get_shape() && X.get_shape().first == active.size(),
+        "Shape must match for rank-k update.");
+    Size_T N = a.get_shape().first;
+    Size_T k = X.get_shape().second;
+    std::vector<V> px (N), py (N);
+    for (Size_T c = 0; c < k; ++c) {
+        std::fill(px.begin(), px.end(), V{});
+        std::fill(py.begin(), py.end(), V{});
+        for (Size_T i = 0; i < active.size(); ++i) {
+            px[active[i]] = X.unsafe_at(i, c);
+            py[active[i]] = Y.unsafe_at(i, c);
+        }
+        detail::ger_kernel(N, N, Default<V>::one, px.data(), 1, py.data(), 1, a.raw_data(), N);
+        bennett(px, py);
+    }
+    monitor();
+}
+
+/// A[i, :] = row, a rank-1 change e_i * (row - A[i, :])^T
+template<typename V>
+void UpdatableLU<V>::replace_row(Size_T i, const Vector<V> &row) {
+    MATLIB_CHECK(V, Assert, i < active.size() && row.size() == active.size(),
+        "Bad row replacement.");
+    Size_T N = a.get_shape().first, p = active[i];
+    std::vector<V> px (N, V{}), py (N, V{});
+    px[p] = Default<V>::one;
+    for (Size_T j = 0; j < active.size(); ++j) {
+        py[active[j]] = row.unsafe_at(j) - a.unsafe_at(p, active[j]);
+        a.unsafe_at(p, active[j]) = row.unsafe_at(j);
+    }
+    bennett(px, py);
+    monitor();
+}
+
+/// A[:, j] = col, a rank-1 change (col - A[:, j]) * e_j^T
+template<typename V>
+void UpdatableLU<V>::replace_col(Size_T j, const Vector<V> &col) {
+    MATLIB_CHECK(V, Assert, j < active.size() && col.size() == active.size(),
+        "Bad column replacement.");
+    Size_T N = a.get_shape().first, p = active[j];
+    std::vector<V> px (N, V{}), py (N, V{});
+    py[p] = Default<V>::one;
+    for (Size_T i = 0; i < active.size(); ++i) {
+        px[active[i]] = col.unsafe_at(i) - a.unsafe_at(active[i], p);
+        a.unsafe_at(active[i], p) = col.unsafe_at(i);
+    }
+    bennett(px, py);
+    monitor();
+}
+
+/// grow to [[A, col], [row^T, diag]]
+///
+/// With PA = LU the bordered factors are L' = [[L, 0], [l^T, 1]] and
+/// U' = [[U, u], [0, diag - l^T u]] where L u = P col and U^T l = row.
+template<typename V>
+void UpdatableLU<V>::append(const Vector<V> &row, const Vector<V> &col, V diag) {
+    MATLIB_CHECK(V, Assert, row.size() == active.size() && col.size() == active.size(),
+        "Size must match for append.");
+    Size_T N = a.get_shape().first;
+    Matrix<V> a_new (N + 1, N + 1), lu_new (N + 1, N + 1);
+    for (Size_T i = 0; i < N; ++i) {
+        std::copy(a.raw_data() + i * N, a.raw_data() + (i + 1) * N, a_new.raw_data() + i * (N + 1));
+        std::copy(lu.raw_data() + i * N, lu.raw_data() + (i + 1) * N, lu_new.raw_data() + i * (N + 1));
+    }
+    std::vector<V> prow (N, V{}), pcol (N, V{});
+    for (Size_T i = 0; i < active.size(); ++i) {
+        prow[active[i]] = row.unsafe_at(i);
+        pcol[active[i]] = col.unsafe_at(i);
+    }
+    for (Size_T i = 0; i < N; ++i) {
+        a_new.unsafe_at(N, i) = prow[i];
+        a_new.unsafe_at(i, N) = pcol[i];
+    }
+    a_new.unsafe_at(N, N) = diag;
+
+    V *f = lu_new.raw_data();
+    Size_T ld = N + 1;
+    // u = L^{-1} P col, stored as the new last column
+    for (Size_T i = 0; i < N; ++i) {
+        f[i * ld + N] = pcol[permute[i]] - detail::dot_serial<V>(i, f + i * ld, 1, f + N, ld);
+    }
+    // l = U^{-T} row, stored as the new last row
+    for (Size_T j = 0; j < N; ++j) {
+        f[N * ld + j] = (prow[j] - detail::dot_serial<V>(j, f + N * ld, 1, f + j, ld)) / f[j * ld + j];
+    }
+    f[N * ld + N] = diag - detail::dot_serial<V>(N, f + N * ld, 1, f + N, ld);
+
+    a = std::move(a_new);
+    lu = std::move(lu_new);
+    permute.push_back(N);
+    active.push_back(N);
+    monitor();
+}
+
+/// drop row and column k, see the class comment
+template<typename V>
+void UpdatableLU<V>::remove(Size_T k) {
+    MATLIB_CHECK(V, Assert, k < active.size(), "Bad index to remove.");
+    Size_T N = a.get_shape().first, p = active[k];
+    std::vector<V> px (N, V{}), py (N, V{});
+    // row p becomes e_p^T
+    px[p] = Default<V>::one;
+    for (Size_T j = 0; j < N; ++j) {
+        py[j] = (j == p ? Default<V>::one : V{}) - a.unsafe_at(p, j);
+        a.unsafe_at(p, j) = j == p ? Default<V>::one : V{};
+    }
+    bennett(px, py);
+    // column p becomes e_p, A[p, p] is already one
+    std::fill(py.begin(), py.end(), V{});
+    py[p] = Default<V>::one;
+    for (Size_T i = 0; i < N; ++i) {
+        px[i] = i == p ? V{} : -a.unsafe_at(i, p);
+        a.unsafe_at(i, p) = i == p ? Default<V>::one : V{};
+    }
+    bennett(px, py);
+    active.erase(active.begin() + static_cast<std::ptrdiff_t>(k));
+    monitor();
+}
+
+/// factor the tracked matrix from scratch, dropping removed indices
+template<typename V>
+void UpdatableLU<V>::refactor() {
+    if (active.size() != a.get_shape().first) {
+        a = matrix();
+        std::iota(active.begin(), active.end(), 0);
+    }
+    lu = a;
+    detail::PLU_inplace(lu, permute);
+    ++refactors;
+    last_drift = probe_drift();
+}
+
+/// Bennett's rank-1 update of L U by x y^T in physical coordinates, x is
+/// given in the row order of A and permuted here; both are clobbered
+///
+/// Peeling the first row and column of L U + x y^T gives
+///   u11' = u11 + x1 y1,  u' = u + x1 y2,  l' = l + x~ y1 / u11'
+/// and leaves L2 U2 + x~ y~^T with x~ = x2 - x1 l, y~ = y2 - (y1 / u11') u'.
+template<typename V>
+void UpdatableLU<V>::bennett(std::vector<V> &x, std::vector<V> &y) {
+    Size_T N = a.get_shape().first;
+    std::vector<V> px (N);
+    for (Size_T i = 0; i < N; ++i) {
+        px[i] = x[permute[i]];
+    }
+    V *f = lu.raw_data();
+    for (Size_T i = 0; i < N; ++i) {
+        V x1 = px[i], y1 = y[i];
+        V *row = f + i * N;
+        row[i] += x1 * y1;
+        V beta = y1 / row[i];
+        for (Size_T j = i + 1; j < N; ++j) {
+            row[j] += x1 * y[j];
+            y[j] -= beta * row[j];
+        }
+        for (Size_T j = i + 1; j < N; ++j) {
+            V &l = f[j * N + i];
+            px[j] -= x1 * l;
+            l += beta * px[j];
+        }
+    }
+}
+
+/// x = A^{-1} b through the factors, in physical coordinates
+template<typename V>
+void UpdatableLU<V>::solve_physical(const V *b, V *x) const {
+    Size_T N = a.get_shape().first;
+    const V *f = lu.raw_data();
+    for (Size_T i = 0; i < N; ++i) {
+        x[i] = b[permute[i]] - detail::dot_serial<V>(i, f + i * N, 1, x, 1);
+    }
+    for (Size_T i = N; i-- > 0;) {
+        const V *row = f + i * N;
+        x[i] = (x[i] - detail::dot_serial<V>(N - i - 1, row + i + 1, 1, x + i + 1, 1)) / row[i];
+    }
+}
+
+/// normwise backward error of a probe solve
+///
+/// eta = |A x - b|_inf / (|A|_inf |x|_inf + |b|_inf) for a fixed b of
+/// alternating signs, costs one solve and one gemv. NaN propagates.
+template<typename V>
+V UpdatableLU<V>::probe_drift() const {
+    Size_T N = a.get_shape().first;
+    if (N == 0) {
+        return V{};
+    }
+    std::vector<V> b (N), x (N), r (N);
+    for (Size_T i = 0; i < N; ++i) {
+        b[i] = static_cast<V>(i % 2 == 0 ? 1 : -1) / static_cast<V>(1 + i % 7);
+    }
+    solve_physical(b.data(), x.data());
+    r = b;
+    detail::gemv_kernel(N, N, Default<V>::one, a.raw_data(), N, x.data(), 1, -Default<V>::one, r.data(), 1);
+    auto max_abs = [](const std::vector<V> &v) {
+        V retval{};
+        for (auto e : v) {
+            // written so that a NaN sticks
+            if (!(std::abs(e) <= retval)) {
+                retval = std::abs(e);
+            }
+        }
+        return retval;
+    };
+    return max_abs(r) / (norm_inf(a) * max_abs(x) + max_abs(b));
+}
+
+/// refactor when the probe says the factors have drifted
+template<typename V>
+void UpdatableLU<V>::monitor() {
+    last_drift = probe_drift();
+    if (!(last_drift <= tolerance)) {
+        refactor();
+    }
+}
+
+}
@@ -2,7 +2,6 @@
 
 // std
 #include <functional>
-#include <optional>
 #include <utility>
 #include <vector>
 #include <type_traits>
@@ -11,6 +10,7 @@
 #include "common.hpp"
 #include "utility.hpp"
 #include "range.hpp"
+#include "vector.hpp"
 
 namespace matlib {
 
@@ -45,13 +45,14 @@ public:
     // slice
     Slice<V, Matrix<V>> slice(Size_T, Size_T, Size_T, Size_T);
     Slice<V, const Matrix<V>> slice(Size_T, Size_T, Size_T, Size_T) const;
+    // vector views
+    VectorView<V, Matrix<V>> row(Size_T);
+    VectorView<V, const Matrix<V>> row(Size_T) const;
+    VectorView<V, Matrix<V>> col(Size_T);
+    VectorView<V, const Matrix<V>> col(Size_T) const;
     // matrix operation
     Matrix transpose() const;
 
-// internal
-private:
-    std::optional<Size_T> offset(Size_T, Size_T) const;
-
 private:
     std::vector<V> data;
     std::pair<Size_T, Size_T> shape;
@@ -71,9 +72,12 @@ class Slice {
     friend class Matrix<V>;
 // function
 public:
+    std::pair<Size_T, Size_T> get_shape() const;
     ElementTypeRef at(Size_T, Size_T);
     ElementTypeRef unsafe_at(Size_T, Size_T);
     SubSliceType slice(Size_T, Size_T, Size_T, Size_T);
+    VectorView<V, MatType> row(Size_T) const;
+    VectorView<V, MatType> col(Size_T) const;
     Matrix<V> to_mat();
 private:
     explicit Slice(Range, Range, MatType &);
@@ -97,7 +101,7 @@ template<typename V>
 Slice<V, Matrix<V>> Matrix<V>::slice(Size_T ra, Size_T rb, Size_T ca, Size_T cb) {
     Range rowRange {ra, rb};
     Range colRange {ca, cb};
-    ASSERT_MSG(rowRange.b < shape.first && colRange.b < shape.second,
+    MATLIB_CHECK(V, Assert, rowRange.b < shape.first && colRange.b < shape.second,
         "Slice output range of matrix.");
     return Slice<V, Matrix<V>> (rowRange, colRange, *this);
 }
@@ -106,11 +110,36 @@ template<typename V>
 Slice<V, const Matrix<V>> Matrix<V>::slice(Size_T ra, Size_T rb, Size_T ca, Size_T cb) const {
     Range rowRange {ra, rb};
     Range colRange {ca, cb};
-    ASSERT_MSG(rowRange.b < shape.first && colRange.b < shape.second,
+    MATLIB_CHECK(V, Assert, rowRange.b < shape.first && colRange.b < shape.second,
         "Slice output range of matrix.");
     return Slice<V, const Matrix<V>> (rowRange, colRange, *this);
 }
 
+/// vector views
+template<typename V>
+VectorView<V, Matrix<V>> Matrix<V>::row(Size_T r) {
+    MATLIB_CHECK(V, Assert, r < shape.first, "Row out of range of matrix.");
+    return VectorView<V, Matrix<V>> (data.data() + r * shape.second, shape.second, 1);
+}
+
+template<typename V>
+VectorView<V, const Matrix<V>> Matrix<V>::row(Size_T r) const {
+    MATLIB_CHECK(V, Assert, r < shape.first, "Row out of range of matrix.");
+    return VectorView<V, const Matrix<V>> (data.data() + r * shape.second, shape.second, 1);
+}
+
+template<typename V>
+VectorView<V, Matrix<V>> Matrix<V>::col(Size_T c) {
+    MATLIB_CHECK(V, Assert, c < shape.second, "Column out of range of matrix.");
+    return VectorView<V, Matrix<V>> (data.data() + c, shape.first, shape.second);
+}
+
+template<typename V>
+VectorView<V, const Matrix<V>> Matrix<V>::col(Size_T c) const {
+    MATLIB_CHECK(V, Assert, c < shape.second, "Column out of range of matrix.");
+    return VectorView<V, const Matrix<V>> (data.data() + c, shape.first, shape.second);
+}
+
 /// matrix operations
 template<typename V>
 Matrix<V> Matrix<V>::transpose() const {
@@ -128,7 +157,7 @@ template<typename V>
 Matrix<V>::Matrix(const std::pair<Size_T, Size_T> &shape, V* raw_data)
     : data(std::vector<V> {0}), shape(shape)
 {
-    ASSERT_MSG(!MultiplyOverflow(shape.first, shape.second), "Bad shape.");
+    MATLIB_CHECK(V, Assert, !MultiplyOverflow(shape.first, shape.second), "Bad shape.");
     if (nullptr == raw_data) {
         this->data = std::vector<V> (shape.first * shape.second, V{});
     } else {
@@ -138,7 +167,7 @@ Matrix<V>::Matrix(const std::pair<Size_T, Size_T> &shape, V* raw_data)
 
 template<typename V>
 Matrix<V>::Matrix(Size_T NR, Size_T NC, V* raw_data) {
-    ASSERT_MSG(!MultiplyOverflow(NR, NC), "Bad shape.");
+    MATLIB_CHECK(V, Assert, !MultiplyOverflow(NR, NC), "Bad shape.");
     this->shape = std::make_pair(NR, NC);
     if (nullptr == raw_data) {
         this->data = std::vector<V> (shape.first * shape.second, V{});
@@ -162,40 +191,26 @@ const V* Matrix<V>::raw_data() const {
     return data.data();
 }
 
-template<typename V>
-std::optional<Size_T> Matrix<V>::offset(Size_T r, Size_T c) const {
-    bool valid = r < shape.first && c < shape.second;
-    if (valid) {
-        return std::make_optional(r * shape.second + c);
-    } else {
-        return std::nullopt;
-    }
-}
-
 template<typename V>
 V& Matrix<V>::unsafe_at(Size_T r, Size_T c) {
-    auto _offset = r * shape.second + c;
-    return data.at(_offset);
+    return data[r * shape.second + c];
 }
 
 template<typename V>
 const V& Matrix<V>::unsafe_at(Size_T r, Size_T c) const {
-    auto _offset = r * shape.second + c;
-    return data.at(_offset);
+    return data[r * shape.second + c];
 }
 
 template<typename V>
 V& Matrix<V>::at(Size_T r, Size_T c) {
-    auto _offset = offset(r, c);
-    ASSERT_MSG(_offset, "Bad indices.");
-    return data.at(_offset.value());
+    MATLIB_CHECK(V, Full, r < shape.first && c < shape.second, "Bad indices.");
+    return data[r * shape.second + c];
 }
 
 template<typename V>
 const V& Matrix<V>::at(Size_T r, Size_T c) const {
-    auto _offset = offset(r, c);
-    ASSERT_MSG(_offset, "Bad indices.");
-    return data.at(_offset.value());  // implicit convert to const ref
+    MATLIB_CHECK(V, Full, r < shape.first && c < shape.second, "Bad indices.");
+    return data[r * shape.second + c];
 }
 
 // iterator
@@ -223,10 +238,33 @@ typename Matrix<V>::ConstRawIterator Matrix<V>::raw_const_end() const {
 /// Slice impl
 namespace matlib {
 
+template<typename V, typename MatType>
+std::pair<Size_T, Size_T> Slice<V, MatType>::get_shape() const {
+    return {rowRange.b - rowRange.a + 1, colRange.b - colRange.a + 1};
+}
+
+template<typename V, typename MatType>
+VectorView<V, MatType> Slice<V, MatType>::row(Size_T i) const {
+    MATLIB_CHECK(V, Assert, i <= rowRange.b - rowRange.a, "Row out of range of slice.");
+    auto &mat = source.get();
+    auto ld = mat.get_shape().second;
+    return VectorView<V, MatType> (mat.raw_data() + (rowRange.a + i) * ld + colRange.a,
+        colRange.b - colRange.a + 1, 1);
+}
+
+template<typename V, typename MatType>
+VectorView<V, MatType> Slice<V, MatType>::col(Size_T j) const {
+    MATLIB_CHECK(V, Assert, j <= colRange.b - colRange.a, "Column out of range of slice.");
+    auto &mat = source.get();
+    auto ld = mat.get_shape().second;
+    return VectorView<V, MatType> (mat.raw_data() + rowRange.a * ld + colRange.a + j,
+        rowRange.b - rowRange.a + 1, ld);
+}
+
 template<typename V, typename MatType>
 typename Slice<V, MatType>::ElementTypeRef Slice<V, MatType>::at(Size_T i, Size_T j) {
     // ASSERT_MSG(source, "Invalid reference to source matrix.");
-    ASSERT_MSG(i <= rowRange.b - rowRange.a && j <= colRange.b - colRange.a,
+    MATLIB_CHECK(V, Full, i <= rowRange.b - rowRange.a && j <= colRange.b - colRange.a,
         "Bad indices out of slice.");
     auto r = i + rowRange.a;
     auto c = j + colRange.a;
@@ -246,7 +284,7 @@ Slice<V, MatType>::slice(Size_T ra, Size_T rb, Size_T ca, Size_T cb) {
     Range newRowRange {ra, rb};
     Range newColRange {ca, cb};
     // ASSERT_MSG(source, "Invalid reference to source matrix");
-    ASSERT_MSG(newRowRange.b <= rowRange.b - rowRange.a
+    MATLIB_CHECK(V, Assert, newRowRange.b <= rowRange.b - rowRange.a
         && newColRange.b <= colRange.b - colRange.a,
         "Sub-slice exceeds the origin one.");
     return typename Slice<V, MatType>::SubSliceType (
@@ -282,5 +320,13 @@ Slice<V, MatType>::Slice(Range rowRange_, Range colRange_, MatType &mat)
 
 // support arithmetic operations
 #include "arithmetic.hpp"
+// reductions
+#include "reduction.hpp"
 // decompositions
 #include "decomposition.hpp"
+// factorizations that follow low-rank updates
+#include "lu_update.hpp"
+// exact, randomized and streaming SVD
+#include "svd.hpp"
+// text input and output
+#include "io.hpp"
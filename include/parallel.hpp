@@ -0,0 +1,103 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+// matlib
+#include "common.hpp"
+
+
+namespace matlib {
+
+namespace detail {
+
+inline std::atomic<Size_T> num_threads_setting {0};
+
+}
+
+/// number of threads used by kernels, 0 restores the hardware default
+inline void set_num_threads(Size_T n) {
+    detail::num_threads_setting.store(n, std::memory_order_relaxed);
+}
+
+inline Size_T get_num_threads() {
+    Size_T n = detail::num_threads_setting.load(std::memory_order_relaxed);
+    if (n == 0) {
+        n = std::thread::hardware_concurrency();
+    }
+    return n == 0 ? 1 : n;
+}
+
+namespace detail {
+
+inline Size_T chunk_count(Size_T total, Size_T grain) {
+    return std::max<Size_T>(1, std::min(get_num_threads(), total / std::max<Size_T>(grain, 1)));
+}
+
+/// call g(chunk, chunk_begin, chunk_end) for `chunks` contiguous pieces of
+/// [begin, end), the first piece on the calling thread
+template<typename G>
+void run_chunks(Size_T begin, Size_T end, Size_T chunks, G &&g) {
+    Size_T total = end - begin;
+    Size_T step = total / chunks, rest = total % chunks;
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    Size_T first_end = begin + step + (rest > 0);
+    Size_T cur = first_end;
+    for (Size_T t = 1; t < chunks; ++t) {
+        Size_T len = step + (t < rest);
+        workers.emplace_back([&g, t, cur, len]() { g(t, cur, cur + len); });
+        cur += len;
+    }
+    g(Size_T{0}, begin, first_end);
+    for (auto &w : workers) {
+        w.join();
+    }
+}
+
+}
+
+/// split [begin, end) into contiguous chunks of at least `grain` elements
+/// and call f(chunk_begin, chunk_end) for each
+template<typename F>
+void parallel_for(Size_T begin, Size_T end, Size_T grain, F &&f) {
+    if (begin >= end) {
+        return;
+    }
+    Size_T chunks = detail::chunk_count(end - begin, grain);
+    if (chunks == 1) {
+        f(begin, end);
+        return;
+    }
+    detail::run_chunks(begin, end, chunks,
+        [&f](Size_T, Size_T b, Size_T e) { f(b, e); });
+}
+
+/// reduce f(chunk_begin, chunk_end) over the chunks of [begin, end), the
+/// partial results are combined in chunk order so the result does not
+/// depend on scheduling
+template<
+    typename T,
+    typename F,
+    typename C>
+T parallel_reduce(Size_T begin, Size_T end, Size_T grain, T init, F &&f, C &&combine) {
+    if (begin >= end) {
+        return init;
+    }
+    Size_T chunks = detail::chunk_count(end - begin, grain);
+    if (chunks == 1) {
+        return combine(init, f(begin, end));
+    }
+    std::vector<T> partial (chunks, init);
+    detail::run_chunks(begin, end, chunks,
+        [&f, &partial](Size_T t, Size_T b, Size_T e) { partial[t] = f(b, e); });
+    T retval = init;
+    for (const auto &p : partial) {
+        retval = combine(retval, p);
+    }
+    return retval;
+}
+
+}
@@ -0,0 +1,465 @@
+#pragma once
+
+// std
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include <vector>
+// matlib
+#include "common.hpp"
+#include "utility.hpp"
+#include "parallel.hpp"
+#include "vector.hpp"
+#include "blas.hpp"
+
+
+namespace matlib {
+
+template<typename> class Matrix;
+template<typename, typename> class Slice;
+
+/// summation algorithm used by sum()
+enum class Summation {
+    Pairwise,
+    Kahan,
+};
+
+}
+
+
+/// reduction kernels on raw strided storage
+namespace matlib::detail {
+
+inline constexpr Size_T reduction_grain = Size_T{1} << 15;
+// below this length pairwise summation stops recursing
+inline constexpr Size_T pairwise_block = 128;
+
+template<
+    typename R,
+    typename X>
+R sum_block(Size_T n, const X *x, Size_T inc) {
+    if (inc != 1) {
+        R acc{};
+        for (Size_T i = 0; i < n; ++i) {
+            acc += x[i * inc];
+        }
+        return acc;
+    }
+    R acc[Lanes] = {};
+    Size_T i = 0;
+    for (; i + Lanes <= n; i += Lanes) {
+        for (Size_T l = 0; l < Lanes; ++l) {
+            acc[l] += x[i + l];
+        }
+    }
+    R tail{};
+    for (; i < n; ++i) {
+        tail += x[i];
+    }
+    for (Size_T w = Lanes / 2; w > 0; w /= 2) {
+        for (Size_T l = 0; l < w; ++l) {
+            acc[l] += acc[l + w];
+        }
+    }
+    return acc[0] + tail;
+}
+
+/// error grows with O(log n) instead of O(n)
+template<
+    typename R,
+    typename X>
+R sum_pairwise(Size_T n, const X *x, Size_T inc) {
+    if (n <= pairwise_block) {
+        return sum_block<R>(n, x, inc);
+    }
+    Size_T half = (n / 2 + Lanes - 1) / Lanes * Lanes;
+    return sum_pairwise<R>(half, x, inc) + sum_pairwise<R>(n - half, x + half * inc, inc);
+}
+
+/// Kahan summation, `comp` holds the low-order bits lost by `sum`
+template<typename R>
+struct KahanSum {
+    R sum{}, comp{};
+
+    void add(R v) {
+        R y = v - comp;
+        R t = sum + y;
+        comp = (t - sum) - y;
+        sum = t;
+    }
+
+    KahanSum merge(const KahanSum &rhs) const {
+        KahanSum retval = *this;
+        retval.add(rhs.sum);
+        retval.add(-rhs.comp);
+        return retval;
+    }
+
+    R value() const {
+        return sum - comp;
+    }
+};
+
+template<
+    typename R,
+    typename X>
+KahanSum<R> sum_kahan(Size_T n, const X *x, Size_T inc) {
+    KahanSum<R> acc;
+    for (Size_T i = 0; i < n; ++i) {
+        acc.add(static_cast<R>(x[i * inc]));
+    }
+    return acc;
+}
+
+template<
+    typename R,
+    typename X>
+R abs_sum(Size_T n, const X *x, Size_T inc) {
+    using std::abs;
+    R acc[Lanes] = {};
+    Size_T i = 0;
+    for (; i + Lanes <= n; i += Lanes) {
+        for (Size_T l = 0; l < Lanes; ++l) {
+            acc[l] += abs(x[(i + l) * inc]);
+        }
+    }
+    R tail{};
+    for (; i < n; ++i) {
+        tail += abs(x[i * inc]);
+    }
+    for (Size_T l = 1; l < Lanes; ++l) {
+        acc[0] += acc[l];
+    }
+    return acc[0] + tail;
+}
+
+/// Cmp(a, b) true when a should replace b, n must be positive
+template<
+    typename Cmp,
+    typename X>
+X extreme(Size_T n, const X *x, Size_T inc, Cmp cmp) {
+    X acc[Lanes];
+    for (Size_T l = 0; l < Lanes; ++l) {
+        acc[l] = x[0];
+    }
+    Size_T i = 0;
+    for (; i + Lanes <= n; i += Lanes) {
+        for (Size_T l = 0; l < Lanes; ++l) {
+            X v = x[(i + l) * inc];
+            acc[l] = cmp(v, acc[l]) ? v : acc[l];
+        }
+    }
+    for (; i < n; ++i) {
+        X v = x[i * inc];
+        acc[0] = cmp(v, acc[0]) ? v : acc[0];
+    }
+    for (Size_T l = 1; l < Lanes; ++l) {
+        acc[0] = cmp(acc[l], acc[0]) ? acc[l] : acc[0];
+    }
+    return acc[0];
+}
+
+/// largest |x_i| and the first index holding it, n must be positive
+///
+/// Two passes: a branch-free maximum the compiler can vectorize, then a
+/// scan for the first match, which is cheaper than tracking indices.
+template<typename X>
+auto argmax_abs_serial(Size_T n, const X *x, Size_T inc) {
+    using std::abs;
+    using R = decltype(abs(X{}));
+    R acc[Lanes] = {};
+    Size_T i = 0;
+    for (; i + Lanes <= n; i += Lanes) {
+        for (Size_T l = 0; l < Lanes; ++l) {
+            R v = abs(x[(i + l) * inc]);
+            acc[l] = v > acc[l] ? v : acc[l];
+        }
+    }
+    for (; i < n; ++i) {
+        R v = abs(x[i * inc]);
+        acc[0] = v > acc[0] ? v : acc[0];
+    }
+    for (Size_T l = 1; l < Lanes; ++l) {
+        acc[0] = acc[l] > acc[0] ? acc[l] : acc[0];
+    }
+    for (i = 0; i < n; ++i) {
+        if (abs(x[i * inc]) == acc[0]) {
+            break;
+        }
+    }
+    // nothing matched, every element is zero or NaN
+    return std::make_pair(acc[0], i == n ? Size_T{0} : i);
+}
+
+/// 2-D strided description of a vector, matrix or slice
+template<typename V>
+struct Strided {
+    using ValueType = V;
+
+    const V *base;
+    Size_T rows, cols, row_stride, col_stride;
+
+    bool contiguous() const {
+        return col_stride == 1 && (rows == 1 || row_stride == cols);
+    }
+};
+
+template<typename V>
+Strided<V> strided(const Vector<V> &x) {
+    return {x.raw_data(), 1, x.size(), x.size(), 1};
+}
+
+template<typename V, typename MatType>
+Strided<V> strided(const VectorView<V, MatType> &x) {
+    return {x.raw_data(), 1, x.size(), x.size() * x.stride(), x.stride()};
+}
+
+template<typename V>
+Strided<V> strided(const Matrix<V> &x) {
+    auto shape = x.get_shape();
+    return {x.raw_data(), shape.first, shape.second, shape.second, 1};
+}
+
+template<typename V, typename MatType>
+Strided<V> strided(const Slice<V, MatType> &x) {
+    auto shape = x.get_shape();
+    return {x.row(0).raw_data(), shape.first, shape.second, x.col(0).stride(), 1};
+}
+
+/// reduce f(n, ptr, inc, first_linear_index) over every element of s in
+/// row-major order, split across threads
+template<
+    typename V,
+    typename T,
+    typename F,
+    typename C>
+T reduce_strided(const Strided<V> &s, T init, F &&f, C &&combine) {
+    if (s.contiguous()) {
+        return parallel_reduce(Size_T{0}, s.rows * s.cols, reduction_grain, init,
+            [&](Size_T b, Size_T e) { return f(e - b, s.base + b, Size_T{1}, b); },
+            combine);
+    }
+    return parallel_reduce(Size_T{0}, s.rows, reduction_grain / std::max<Size_T>(s.cols, 1) + 1, init,
+        [&](Size_T b, Size_T e) {
+            T acc = f(s.cols, s.base + b * s.row_stride, s.col_stride, b * s.cols);
+            for (Size_T r = b + 1; r < e; ++r) {
+                acc = combine(acc, f(s.cols, s.base + r * s.row_stride, s.col_stride, r * s.cols));
+            }
+            return acc;
+        },
+        combine);
+}
+
+template<typename T>
+struct is_reducible : is_vector<T> {};
+template<typename V>
+struct is_reducible<Matrix<V>> : std::true_type {};
+template<typename V, typename MatType>
+struct is_reducible<Slice<V, MatType>> : std::true_type {};
+
+template<typename T>
+inline constexpr bool is_reducible_v = is_reducible<std::decay_t<T>>::value;
+
+template<typename T>
+using enable_reducible = std::enable_if_t<is_reducible_v<T>>;
+
+template<typename T>
+using value_t = typename decltype(strided(std::declval<const T&>()))::ValueType;
+
+}
+
+
+/// reductions over Vector, VectorView, Matrix and Slice
+namespace matlib {
+
+template<
+    typename T,
+    typename = detail::enable_reducible<T>>
+auto sum(const T &x, Summation method = Summation::Pairwise) {
+    using R = detail::value_t<T>;
+    auto s = detail::strided(x);
+    if (method == Summation::Kahan) {
+        using K = detail::KahanSum<R>;
+        return detail::reduce_strided(s, K{},
+            [](Size_T n, const R *p, Size_T inc, Size_T) { return detail::sum_kahan<R>(n, p, inc); },
+            [](const K &a, const K &b) { return a.merge(b); }).value();
+    }
+    return detail::reduce_strided(s, R{},
+        [](Size_T n, const R *p, Size_T inc, Size_T) { return detail::sum_pairwise<R>(n, p, inc); },
+        [](R a, R b) { return a + b; });
+}
+
+/// euclidean norm of a vector, frobenius norm of a matrix
+template<
+    typename T,
+    typename = detail::enable_reducible<T>>
+auto norm_fro(const T &x) {
+    auto s = detail::strided(x);
+    if (s.contiguous()) {
+        return detail::nrm2_kernel(s.rows * s.cols, s.base, 1);
+    }
+    // norm of the row norms, overflow-safe like nrm2 itself
+    using R = decltype(detail::nrm2_kernel(Size_T{}, s.base, 1));
+    std::vector<R> row_norms (s.rows);
+    parallel_for(Size_T{0}, s.rows, detail::reduction_grain / std::max<Size_T>(s.cols, 1) + 1,
+        [&](Size_T b, Size_T e) {
+            for (Size_T r = b; r < e; ++r) {
+                row_norms[r] = detail::nrm2_kernel(s.cols, s.base + r * s.row_stride, s.col_stride);
+            }
+        });
+    return detail::nrm2_kernel(s.rows, row_norms.data(), 1);
+}
+
+/// sum of |x_i| for vectors, maximum absolute column sum for matrices
+template<
+    typename T,
+    typename = detail::enable_reducible<T>>
+auto norm_1(const T &x) {
+    using std::abs;
+    using V = detail::value_t<T>;
+    using R = decltype(abs(V{}));
+    auto s = detail::strided(x);
+    if constexpr (is_vector_v<T>) {
+        return detail::reduce_strided(s, R{},
+            [](Size_T n, const V *p, Size_T inc, Size_T) { return detail::abs_sum<R>(n, p, inc); },
+            [](R a, R b) { return a + b; });
+    } else {
+        // accumulate whole rows so the inner loop stays unit-stride
+        std::vector<R> col_sums (s.cols, R{});
+        parallel_for(Size_T{0}, s.cols, detail::reduction_grain / std::max<Size_T>(s.rows, 1) + 1,
+            [&](Size_T b, Size_T e) {
+                for (Size_T r = 0; r < s.rows; ++r) {
+                    const V *row = s.base + r * s.row_stride;
+                    for (Size_T c = b; c < e; ++c) {
+                        col_sums[c] += abs(row[c]);
+                    }
+                }
+            });
+        return s.cols == 0 ? R{} : detail::extreme(s.cols, col_sums.data(), 1,
+            [](R a, R b) { return a > b; });
+    }
+}
+
+/// maximum |x_i| for vectors, maximum absolute row sum for matrices
+template<
+    typename T,
+    typename = detail::enable_reducible<T>>
+auto norm_inf(const T &x) {
+    using std::abs;
+    using V = detail::value_t<T>;
+    using R = decltype(abs(V{}));
+    auto s = detail::strided(x);
+    if constexpr (is_vector_v<T>) {
+        return s.cols == 0 ? R{} : detail::argmax_abs_serial(s.cols, s.base, s.col_stride).first;
+    } else {
+        return parallel_reduce(Size_T{0}, s.rows, detail::reduction_grain / std::max<Size_T>(s.cols, 1) + 1, R{},
+            [&](Size_T b, Size_T e) {
+                R acc{};
+                for (Size_T r = b; r < e; ++r) {
+                    R cur = detail::abs_sum<R>(s.cols, s.base + r * s.row_stride, s.col_stride);
+                    acc = cur > acc ? cur : acc;
+                }
+                return acc;
+            },
+            [](R a, R b) { return a > b ? a : b; });
+    }
+}
+
+template<
+    typename T,
+    typename = detail::enable_reducible<T>>
+auto min(const T &x) {
+    using V = detail::value_t<T>;
+    auto s = detail::strided(x);
+    MATLIB_CHECK(V, Assert, s.rows * s.cols > 0, "Minimum of empty range.");
+    auto cmp = [](V a, V b) { return a < b; };
+    return detail::reduce_strided(s, s.base[0],
+        [&](Size_T n, const V *p, Size_T inc, Size_T) { return detail::extreme(n, p, inc, cmp); },
+        [&](V a, V b) { return cmp(b, a) ? b : a; });
+}
+
+template<
+    typename T,
+    typename = detail::enable_reducible<T>>
+auto max(const T &x) {
+    using V = detail::value_t<T>;
+    auto s = detail::strided(x);
+    MATLIB_CHECK(V, Assert, s.rows * s.cols > 0, "Maximum of empty range.");
+    auto cmp = [](V a, V b) { return a > b; };
+    return detail::reduce_strided(s, s.base[0],
+        [&](Size_T n, const V *p, Size_T inc, Size_T) { return detail::extreme(n, p, inc, cmp); },
+        [&](V a, V b) { return cmp(b, a) ? b : a; });
+}
+
+/// index of the first element with the largest magnitude, a flat index
+/// for vectors and a (row, column) pair for matrices and slices
+template<
+    typename T,
+    typename = detail::enable_reducible<T>>
+auto argmax_abs(const T &x) {
+    using std::abs;
+    using V = detail::value_t<T>;
+    using R = decltype(abs(V{}));
+    using Best = std::pair<R, Size_T>;
+    auto s = detail::strided(x);
+    MATLIB_CHECK(V, Assert, s.rows * s.cols > 0, "Argmax of empty range.");
+    Best best = detail::reduce_strided(s, Best{R{}, 0},
+        [](Size_T n, const V *p, Size_T inc, Size_T first) {
+            auto local = detail::argmax_abs_serial(n, p, inc);
+            return Best{local.first, local.second + first};
+        },
+        // partials arrive in order, ties keep the earlier index
+        [](const Best &a, const Best &b) { return b.first > a.first ? b : a; });
+    if constexpr (is_vector_v<T>) {
+        return best.second;
+    } else {
+        return std::make_pair(best.second / s.cols, best.second % s.cols);
+    }
+}
+
+/// true if pred holds for some element, pred defaults to "nonzero"
+template<
+    typename T,
+    typename P,
+    typename = detail::enable_reducible<T>>
+bool any(const T &x, P pred) {
+    using V = detail::value_t<T>;
+    return detail::reduce_strided(detail::strided(x), false,
+        [&](Size_T n, const V *p, Size_T inc, Size_T) {
+            for (Size_T i = 0; i < n; ++i) {
+                if (pred(p[i * inc])) {
+                    return true;
+                }
+            }
+            return false;
+        },
+        [](bool a, bool b) { return a || b; });
+}
+
+template<
+    typename T,
+    typename = detail::enable_reducible<T>>
+bool any(const T &x) {
+    using V = detail::value_t<T>;
+    return any(x, [](const V &v) { return v != Default<V>::zero; });
+}
+
+/// true if pred holds for every element, pred defaults to "nonzero"
+template<
+    typename T,
+    typename P,
+    typename = detail::enable_reducible<T>>
+bool all(const T &x, P pred) {
+    using V = detail::value_t<T>;
+    return !any(x, [&](const V &v) { return !pred(v); });
+}
+
+template<
+    typename T,
+    typename = detail::enable_reducible<T>>
+bool all(const T &x) {
+    using V = detail::value_t<T>;
+    return all(x, [](const V &v) { return v != Default<V>::zero; });
+}
+
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include <vector>
+// matlib
+#include "common.hpp"
+#include "utility.hpp"
+#include "parallel.hpp"
+#include "blas.hpp"
+
+
+/// Strassen-Winograd multiplication
+///
+/// One level computes the product of the even-sized leading blocks with 7
+/// half-size products and 15 block additions, following the schedule of
+/// Boyer, Dumas, Pernet and Zhou ("Memory efficient scheduling of
+/// Strassen-Winograd's matrix multiplication algorithm", 2009) that only
+/// needs two temporaries and uses the quadrants of C as scratch. An odd
+/// trailing row, column or inner dimension is peeled off and fixed up with
+/// gemv/ger, so no operand is ever padded.
+namespace matlib::detail {
+
+inline std::atomic<Size_T> strassen_threshold_setting {4096};
+
+/// C = A + B (sign > 0) or C = A - B on m x n strided blocks
+template<typename T>
+void block_add(Size_T m, Size_T n, const T *a, Size_T lda, const T *b, Size_T ldb,
+        T *c, Size_T ldc, bool add) {
+    parallel_for(Size_T{0}, m, level1_grain / std::max<Size_T>(n, 1) + 1, [=](Size_T rb, Size_T re) {
+        for (Size_T i = rb; i < re; ++i) {
+            const T *ai = a + i * lda, *bi = b + i * ldb;
+            T *ci = c + i * ldc;
+            if (add) {
+                for (Size_T j = 0; j < n; ++j) {
+                    ci[j] = ai[j] + bi[j];
+                }
+            } else {
+                for (Size_T j = 0; j < n; ++j) {
+                    ci[j] = ai[j] - bi[j];
+                }
+            }
+        }
+    });
+}
+
+/// elements of workspace needed below one level of size m x k x n
+inline Size_T strassen_workspace(Size_T m, Size_T k, Size_T n, Size_T cutoff) {
+    Size_T retval = 0;
+    while (std::min({m, k, n}) > cutoff && std::min({m, k, n}) >= 2) {
+        m /= 2, k /= 2, n /= 2;
+        // X holds S_i (m x k) and later P1 (m x n), Y holds T_i (k x n)
+        retval += m * std::max(k, n) + k * n;
+    }
+    return retval;
+}
+
+/// C = A * B, A is m x k, B is k x n, all row-major and strided, C is
+/// overwritten; `work` holds at least strassen_workspace(m, k, n, cutoff)
+template<typename T>
+void strassen_winograd(Size_T m, Size_T k, Size_T n, const T *a, Size_T lda,
+        const T *b, Size_T ldb, T *c, Size_T ldc, Size_T cutoff, T *work) {
+    if (std::min({m, k, n}) <= cutoff || std::min({m, k, n}) < 2) {
+        gemm_kernel(m, k, n, Default<T>::one, a, lda, b, ldb, Default<T>::zero, c, ldc);
+        return;
+    }
+    Size_T m2 = m / 2, k2 = k / 2, n2 = n / 2;
+    // quadrants of the even leading blocks
+    const T *a11 = a, *a12 = a + k2, *a21 = a + m2 * lda, *a22 = a21 + k2;
+    const T *b11 = b, *b12 = b + n2, *b21 = b + k2 * ldb, *b22 = b21 + n2;
+    T *c11 = c, *c12 = c + n2, *c21 = c + m2 * ldc, *c22 = c21 + n2;
+    // X is m2 x k2 (ld k2) for S_i, m2 x n2 (ld n2) for P1; Y is k2 x n2
+    T *x = work, *y = work + m2 * std::max(k2, n2), *next = y + k2 * n2;
+
+    block_add(m2, k2, a11, lda, a21, lda, x, k2, false);        // S3 = A11 - A21
+    block_add(k2, n2, b22, ldb, b12, ldb, y, n2, false);        // T3 = B22 - B12
+    strassen_winograd(m2, k2, n2, x, k2, y, n2, c21, ldc, cutoff, next);   // P7 = S3 T3
+    block_add(m2, k2, a21, lda, a22, lda, x, k2, true);         // S1 = A21 + A22
+    block_add(k2, n2, b12, ldb, b11, ldb, y, n2, false);        // T1 = B12 - B11
+    strassen_winograd(m2, k2, n2, x, k2, y, n2, c22, ldc, cutoff, next);   // P5 = S1 T1
+    block_add(m2, k2, x, k2, a11, lda, x, k2, false);           // S2 = S1 - A11
+    block_add(k2, n2, b22, ldb, y, n2, y, n2, false);           // T2 = B22 - T1
+    strassen_winograd(m2, k2, n2, x, k2, y, n2, c12, ldc, cutoff, next);   // P6 = S2 T2
+    block_add(m2, k2, a12, lda, x, k2, x, k2, false);           // S4 = A12 - S2
+    strassen_winograd(m2, k2, n2, x, k2, b22, ldb, c11, ldc, cutoff, next); // P3 = S4 B22
+    strassen_winograd(m2, k2, n2, a11, lda, b11, ldb, x, n2, cutoff, next); // P1 = A11 B11
+    block_add(m2, n2, x, n2, c12, ldc, c12, ldc, true);         // U2 = P1 + P6
+    block_add(m2, n2, c12, ldc, c21, ldc, c21, ldc, true);      // U3 = U2 + P7
+    block_add(m2, n2, c12, ldc, c22, ldc, c12, ldc, true);      // U4 = U2 + P5
+    block_add(m2, n2, c21, ldc, c22, ldc, c22, ldc, true);      // U7 = U3 + P5
+    block_add(m2, n2, c12, ldc, c11, ldc, c12, ldc, true);      // U5 = U4 + P3
+    block_add(k2, n2, y, n2, b21, ldb, y, n2, false);           // T4 = T2 - B21
+    strassen_winograd(m2, k2, n2, a22, lda, y, n2, c11, ldc, cutoff, next); // P4 = A22 T4
+    block_add(m2, n2, c21, ldc, c11, ldc, c21, ldc, false);     // U6 = U3 - P4
+    strassen_winograd(m2, k2, n2, a12, lda, b21, ldb, c11, ldc, cutoff, next); // P2 = A12 B21
+    block_add(m2, n2, x, n2, c11, ldc, c11, ldc, true);         // U1 = P1 + P2
+
+    // dynamic peeling of the odd trailing parts
+    Size_T me = 2 * m2, ke = 2 * k2, ne = 2 * n2;
+    if (k != ke) {
+        // C[0:me, 0:ne] += A[0:me, k-1] B[k-1, 0:ne]
+        ger_kernel(me, ne, Default<T>::one, a + ke, lda, b + ke * ldb, 1, c, ldc);
+    }
+    if (n != ne) {
+        // C[0:me, n-1] = A[0:me, :] B[:, n-1]
+        gemv_kernel(me, k, Default<T>::one, a, lda, b + ne, ldb,
+            Default<T>::zero, c + ne, ldc);
+    }
+    if (m != me) {
+        // C[m-1, :] = A[m-1, :] B
+        gemv_t_kernel(k, n, Default<T>::one, b, ldb, a + me * lda, 1,
+            Default<T>::zero, c + me * ldc, 1);
+    }
+}
+
+}
+
+
+namespace matlib {
+
+template<typename> class Matrix;
+
+/// recursion stops and the classical kernel takes over at this size
+inline constexpr Size_T default_strassen_cutoff = 256;
+
+/// operator* switches to Strassen-Winograd once every dimension reaches
+/// `n`, 0 never switches
+inline void set_strassen_threshold(Size_T n) {
+    detail::strassen_threshold_setting.store(n, std::memory_order_relaxed);
+}
+
+inline Size_T get_strassen_threshold() {
+    return detail::strassen_threshold_setting.load(std::memory_order_relaxed);
+}
+
+/// elements of scratch space strassen_multiply needs for an m x k by k x n
+/// product, at most (m * max(k, n) + k * n) / 3
+inline Size_T strassen_workspace_size(Size_T m, Size_T k, Size_T n,
+        Size_T cutoff = default_strassen_cutoff) {
+    return detail::strassen_workspace(m, k, n, cutoff);
+}
+
+/// A * B by Strassen-Winograd, `workspace` is grown when too small and can
+/// be kept between calls to avoid reallocating
+template<typename V>
+Matrix<V> strassen_multiply(const Matrix<V> &lhs, const Matrix<V> &rhs,
+        std::vector<V> &workspace, Size_T cutoff = default_strassen_cutoff) {
+    MATLIB_CHECK(V, Assert, lhs.get_shape().second == rhs.get_shape().first,
+        "Shape must match for multiplication.");
+    MATLIB_CHECK(V, Assert, cutoff > 0, "Strassen cutoff must be positive.");
+    auto lshape = lhs.get_shape();
+    auto rshape = rhs.get_shape();
+    Size_T m = lshape.first, k = lshape.second, n = rshape.second;
+
+    Matrix<V> retval(m, n);
+    Size_T need = detail::strassen_workspace(m, k, n, cutoff);
+    if (workspace.size() < need) {
+        workspace.resize(need);
+    }
+    detail::strassen_winograd(m, k, n, lhs.raw_data(), k, rhs.raw_data(), n,
+        retval.raw_data(), n, cutoff, workspace.data());
+    return retval;
+}
+
+template<typename V>
+Matrix<V> strassen_multiply(const Matrix<V> &lhs, const Matrix<V> &rhs,
+        Size_T cutoff = default_strassen_cutoff) {
+    std::vector<V> workspace;
+    return strassen_multiply(lhs, rhs, workspace, cutoff);
+}
+
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
+// matlib
+#include "common.hpp"
+#include "utility.hpp"
+#include "blas.hpp"
+#include "decomposition.hpp"
+
+
+namespace matlib {
+
+template<typename> class Matrix;
+template<typename> class Vector;
+
+namespace detail {
+
+/// one-sided Jacobi SVD of an r x c row-major X with r <= c
+///
+/// Rows of X are rotated pairwise until they are mutually orthogonal,
+/// J X = D, so X = J^T D = (J^T) diag(|d_i|) (D / |d_i|). Accurate to
+/// working precision even for tiny singular values, O(r^2 c) per sweep.
+/// U is r x r, s has r entries in descending order, Vt is r x c; rows of
+/// Vt belonging to zero singular values are left zero.
+template<typename T>
+void jacobi_svd_rows(Size_T r, Size_T c, const T *x, T *u, T *s, T *vt) {
+    std::vector<T> d (x, x + r * c), j (r * r, T{});
+    for (Size_T i = 0; i < r; ++i) {
+        j[i * r + i] = Default<T>::one;
+    }
+    auto rotate = [](Size_T n, T *p, T *q, T cs, T sn) {
+        for (Size_T k = 0; k < n; ++k) {
+            T a = p[k], b = q[k];
+            p[k] = cs * a - sn * b;
+            q[k] = sn * a + cs * b;
+        }
+    };
+    const T eps = std::numeric_limits<T>::epsilon();
+    for (int sweep = 0; sweep < 64; ++sweep) {
+        bool rotated = false;
+        for (Size_T p = 0; p + 1 < r; ++p) {
+            for (Size_T q = p + 1; q < r; ++q) {
+                T *dp = d.data() + p * c, *dq = d.data() + q * c;
+                T alpha = dot_serial<T>(c, dp, 1, dp, 1);
+                T beta = dot_serial<T>(c, dq, 1, dq, 1);
+                T gamma = dot_serial<T>(c, dp, 1, dq, 1);
+                if (!(std::abs(gamma) > eps * std::sqrt(alpha * beta)) || gamma == T{}) {
+                    continue;
+                }
+                rotated = true;
+                // zero the (p, q) entry of the 2 x 2 Gram matrix
+                T zeta = (beta - alpha) / (2 * gamma);
+                T t = std::copysign(Default<T>::one, zeta) / (std::abs(zeta) + std::hypot(Default<T>::one, zeta));
+                T cs = Default<T>::one / std::hypot(Default<T>::one, t), sn = cs * t;
+                rotate(c, dp, dq, cs, sn);
+                rotate(r, j.data() + p * r, j.data() + q * r, cs, sn);
+            }
+        }
+        if (!rotated) {
+            break;
+        }
+    }
+    std::vector<T> norms (r);
+    for (Size_T i = 0; i < r; ++i) {
+        norms[i] = nrm2_kernel(c, d.data() + i * c, 1);
+    }
+    std::vector<Size_T> order (r);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](Size_T a, Size_T b) { return norms[a] > norms[b]; });
+    for (Size_T k = 0; k < r; ++k) {
+        Size_T i = order[k];
+        s[k] = norms[i];
+        T inv = norms[i] > T{} ? Default<T>::one / norms[i] : T{};
+        for (Size_T l = 0; l < c; ++l) {
+            vt[k * c + l] = d[i * c + l] * inv;
+        }
+        // column k of U is row i of J
+        for (Size_T l = 0; l < r; ++l) {
+            u[l * r + k] = j[i * r + l];
+        }
+    }
+}
+
+template<typename V>
+Matrix<V> gaussian_matrix(Size_T NR, Size_T NC, std::mt19937_64 &rng) {
+    std::normal_distribution<V> dist;
+    Matrix<V> retval (NR, NC);
+    for (auto it = retval.raw_begin(); it != retval.raw_end(); ++it) {
+        *it = dist(rng);
+    }
+    return retval;
+}
+
+template<typename V>
+Matrix<V> orthonormal_basis(const Matrix<V> &Y) {
+    return std::get<0>(QR_decomposite(Y));
+}
+
+/// U = Q U_core truncated to `rank` columns, with S and Vt truncated too
+template<typename V>
+std::tuple<Matrix<V>, Vector<V>, Matrix<V>>
+truncate_svd(const Matrix<V> &Q, const Matrix<V> &core, Size_T rank);
+
+}
+
+/// thin SVD A = U diag(S) Vt by one-sided Jacobi, U is m x k, S has
+/// k = min(m, n) entries in descending order, Vt is k x n
+///
+/// Meant as the exact reference and for small cores; it is O(mn min(m, n))
+/// per sweep.
+template<typename V>
+std::tuple<Matrix<V>, Vector<V>, Matrix<V>>
+SVD_decomposite(const Matrix<V> &mat) {
+    auto [m, n] = mat.get_shape();
+    Size_T k = std::min(m, n);
+    Matrix<V> U (m, k), Vt (k, n);
+    Vector<V> S (k);
+    if (m <= n) {
+        detail::jacobi_svd_rows(m, n, mat.raw_data(), U.raw_data(), S.raw_data(), Vt.raw_data());
+    } else {
+        // A^T = U' S Vt'  =>  A = Vt'^T S U'^T
+        auto At = mat.transpose();
+        Matrix<V> Ut (n, n), Vtt (n, m);
+        detail::jacobi_svd_rows(n, m, At.raw_data(), Ut.raw_data(), S.raw_data(), Vtt.raw_data());
+        U = Vtt.transpose();
+        Vt = Ut.transpose();
+    }
+    return {U, S, Vt};
+}
+
+/// rank-`rank` truncated SVD by a randomized range finder
+///
+/// Y = A Omega with a Gaussian n x (rank + oversampling) Omega, Q = qr(Y);
+/// each power iteration replaces Q by qr(A qr(A^T Q)), which sharpens a
+/// slowly decaying spectrum at the cost of two more passes over A. The
+/// small core Q^T A is then decomposed exactly. Halko, Martinsson and
+/// Tropp, "Finding structure with randomness", 2011.
+template<typename V>
+std::tuple<Matrix<V>, Vector<V>, Matrix<V>>
+randomized_svd(const Matrix<V> &A, Size_T rank, Size_T oversampling = 10,
+        Size_T power_iterations = 2, std::uint64_t seed = 0) {
+    auto [m, n] = A.get_shape();
+    MATLIB_CHECK(V, Assert, rank > 0 && rank <= std::min(m, n), "Rank out of range.");
+    Size_T l = std::min({rank + oversampling, m, n});
+    std::mt19937_64 rng (seed);
+    auto At = A.transpose();
+    Matrix<V> Q = detail::orthonormal_basis(A * detail::gaussian_matrix<V>(n, l, rng));
+    for (Size_T q = 0; q < power_iterations; ++q) {
+        Q = detail::orthonormal_basis(A * detail::orthonormal_basis(At * Q));
+    }
+    // core B = Q^T A is l x n
+    return detail::truncate_svd(Q, Q.transpose() * A, rank);
+}
+
+/// single-pass randomized SVD of a matrix that arrives as row blocks
+///
+/// Each block A_i updates two sketches and is then dropped: the range
+/// sketch Y_i = A_i Omega and the co-range sketch W += Psi_i^T A_i. With
+/// Q = qr(Y) the core X solves (Psi^T Q) X = W in the least-squares sense,
+/// so A ~ Q X. Tropp, Yurtsever, Udell and Cevher, "Practical sketching
+/// algorithms for low-rank matrix approximation", 2017. There are no
+/// power iterations, so expect a larger error than randomized_svd on
+/// slowly decaying spectra.
+template<typename V>
+class StreamingSVD {
+// methods
+public:
+    StreamingSVD(Size_T cols, Size_T rank, Size_T oversampling = 10, std::uint64_t seed = 0);
+    Size_T rows() const;
+    void push_rows(const Matrix<V> &);
+    std::tuple<Matrix<V>, Vector<V>, Matrix<V>> finalize() const;
+
+private:
+    Size_T cols, rank, l, l2;
+    std::mt19937_64 rng;
+    Matrix<V> omega;
+    // m x l range sketch and m x l2 co-range test matrix, grown by row
+    std::vector<V> y, psi;
+    // l2 x n co-range sketch
+    Matrix<V> w;
+};
+
+}
+
+
+/// ======================================
+/// implementation
+
+namespace matlib {
+
+template<typename V>
+std::tuple<Matrix<V>, Vector<V>, Matrix<V>>
+detail::truncate_svd(const Matrix<V> &Q, const Matrix<V> &core, Size_T rank) {
+    auto [Uc, Sc, Vtc] = SVD_decomposite(core);
+    Size_T l = Uc.get_shape().first, n = Vtc.get_shape().second;
+    rank = std::min(rank, Sc.size());
+    Matrix<V> Ur (l, rank), Vt (rank, n);
+    for (Size_T i = 0; i < l; ++i) {
+        std::copy(Uc.raw_data() + i * Uc.get_shape().second,
+            Uc.raw_data() + i * Uc.get_shape().second + rank, Ur.raw_data() + i * rank);
+    }
+    std::copy(Vtc.raw_data(), Vtc.raw_data() + rank * n, Vt.raw_data());
+    return {Q * Ur, Vector<V>(rank, Sc.raw_data()), Vt};
+}
+
+template<typename V>
+StreamingSVD<V>::StreamingSVD(Size_T cols_, Size_T rank_, Size_T oversampling, std::uint64_t seed)
+    : cols(cols_), rank(rank_), l(std::min(rank_ + oversampling, cols_)), l2(2 * l + 1),
+    rng(seed), omega(detail::gaussian_matrix<V>(cols_, l, rng)), w(l2, cols_)
+{
+    MATLIB_CHECK(V, Assert, rank > 0 && rank <= cols, "Rank out of range.");
+}
+
+template<typename V>
+Size_T StreamingSVD<V>::rows() const {
+    return y.size() / l;
+}
+
+template<typename V>
+void StreamingSVD<V>::push_rows(const Matrix<V> &block) {
+    MATLIB_CHECK(V, Assert, block.get_shape().second == cols, "Block width must match.");
+    Size_T r = block.get_shape().first;
+    auto yb = block * omega;
+    auto pb = detail::gaussian_matrix<V>(r, l2, rng);
+    y.insert(y.end(), yb.raw_data(), yb.raw_data() + r * l);
+    psi.insert(psi.end(), pb.raw_data(), pb.raw_data() + r * l2);
+    // W += Psi_i^T A_i
+    auto pbt = pb.transpose();
+    detail::gemm_kernel(l2, r, cols, Default<V>::one, pbt.raw_data(), r,
+        block.raw_data(), cols, Default<V>::one, w.raw_data(), cols);
+}
+
+template<typename V>
+std::tuple<Matrix<V>, Vector<V>, Matrix<V>> StreamingSVD<V>::finalize() const {
+    Size_T m = rows();
+    MATLIB_CHECK(V, Assert, rank <= m, "Fewer rows than the requested rank.");
+    Matrix<V> Y (m, l), Psi (m, l2);
+    std::copy(y.begin(), y.end(), Y.raw_data());
+    std::copy(psi.begin(), psi.end(), Psi.raw_data());
+    // m x min(m, l)
+    Matrix<V> Q = detail::orthonormal_basis(Y);
+    // (Psi^T Q) X = W in the least-squares sense, Psi^T Q is l2 x min(m, l)
+    auto X = least_squares(Psi.transpose() * Q, w);
+    return detail::truncate_svd(Q, X, rank);
+}
+
+}
@@ -1,23 +1,67 @@
 #pragma once
 
-#include <limits>
-#include <iostream>
+#include <cmath>
+#include <cstdio>
 #include <cstdlib>
+#include <limits>
 
 #define ASSERT_MSG(expression, message) \
     do { if (!(expression)) { \
-        std::cerr << "Assertion failed: (" << #expression << "), \n" \
-                  << "\tfunction: " << __FUNCTION__ << '\n' \
-                  << "\tfile:     " << __FILE__ << '\n' \
-                  << "\tline:     " << __LINE__ << "\n" \
-                  << "\tMessage:  " << message << std::endl; \
-        std::abort(); \
+        ::matlib::detail::assert_fail(#expression, __FUNCTION__, __FILE__, __LINE__, message); \
     } } while (false)
 #define ASSERT_EQ(a, b) ASSERT_MSG((a)==(b), "")
 #define ASSERT_NE(a, b) ASSERT_MSG((a)!=(b), "")
 
+/// checking level used by the library unless a value type overrides it,
+/// 0 = none, 1 = assert (argument and shape checks), 2 = full (also every
+/// element access through at())
+#ifndef MATLIB_CHECK_LEVEL
+#ifdef NDEBUG
+#define MATLIB_CHECK_LEVEL 1
+#else
+#define MATLIB_CHECK_LEVEL 2
+#endif
+#endif
+
+/// check `expression` only if CheckPolicy<V> is at least `min_level`
+#define MATLIB_CHECK(V, min_level, expression, message) \
+    do { if constexpr (::matlib::CheckPolicy<V>::level >= ::matlib::Check::min_level) { \
+        ASSERT_MSG(expression, message); \
+    } } while (false)
+
 namespace matlib {
 
+namespace detail {
+
+// kept out of line so failed checks do not bloat the hot paths
+[[noreturn, gnu::cold, gnu::noinline]] inline void assert_fail(const char *expression, const char *function,
+        const char *file, int line, const char *message) {
+    std::fprintf(stderr, "Assertion failed: (%s), \n"
+        "\tfunction: %s\n"
+        "\tfile:     %s\n"
+        "\tline:     %d\n"
+        "\tMessage:  %s\n",
+        expression, function, file, line, message);
+    std::abort();
+}
+
+}
+
+/// checking policy
+enum class Check {
+    None = 0,
+    Assert = 1,
+    Full = 2,
+};
+
+inline constexpr Check default_check = static_cast<Check>(MATLIB_CHECK_LEVEL);
+
+/// specialize to pick a different level for matrices of one value type
+template<typename V>
+struct CheckPolicy {
+    static constexpr Check level = default_check;
+};
+
 template<typename T>
 auto epsilon = T{};
 
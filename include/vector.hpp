@@ -0,0 +1,237 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <vector>
+#include <type_traits>
+
+// matlib
+#include "common.hpp"
+#include "utility.hpp"
+#include "range.hpp"
+
+
+namespace matlib {
+
+template<typename> class Matrix;
+template<typename, typename> class Slice;
+template<typename> class Vector;
+template<typename, typename> class VectorView;
+
+/// Vector
+template<typename V>
+class Vector {
+// members
+public:
+    using ValueType = V;
+    using RawIterator = typename std::vector<V>::iterator;
+    using ConstRawIterator = typename std::vector<V>::const_iterator;
+// methods
+public:
+    // construct
+    explicit Vector(Size_T N, const V* = nullptr);
+    // access
+    Size_T size() const;
+    Size_T stride() const;
+    V* raw_data();
+    const V* raw_data() const;
+    V& unsafe_at(Size_T);
+    const V& unsafe_at(Size_T) const;
+    V& at(Size_T);
+    const V& at(Size_T) const;
+    // iterator
+    RawIterator raw_begin();
+    RawIterator raw_end();
+    ConstRawIterator raw_const_begin() const;
+    ConstRawIterator raw_const_end() const;
+    // conversion
+    Matrix<V> to_mat() const;
+
+private:
+    std::vector<V> data;
+};
+
+/// VectorView, a strided view over a row or column of a matrix
+template<
+    typename V,
+    typename MatType>
+class VectorView {
+    using ElementTypeRef = std::conditional_t<std::is_const_v<MatType>,
+        const V&,
+        V&>;
+    using ElementTypePtr = std::conditional_t<std::is_const_v<MatType>,
+        const V*,
+        V*>;
+    friend class Matrix<V>;
+    friend class Slice<V, MatType>;
+// members
+public:
+    using ValueType = V;
+// function
+public:
+    Size_T size() const;
+    Size_T stride() const;
+    ElementTypePtr raw_data() const;
+    ElementTypeRef at(Size_T) const;
+    ElementTypeRef unsafe_at(Size_T) const;
+    VectorView slice(Size_T, Size_T) const;
+    Vector<V> to_vec() const;
+private:
+    VectorView(ElementTypePtr, Size_T, Size_T);
+
+// member
+private:
+    ElementTypePtr base;
+    Size_T length, step;
+};
+
+/// vector-like detection for the level-1 and level-2 routines
+template<typename>
+struct is_vector : std::false_type {};
+template<typename V>
+struct is_vector<Vector<V>> : std::true_type {};
+template<typename V, typename MatType>
+struct is_vector<VectorView<V, MatType>> : std::true_type {};
+
+template<typename T>
+inline constexpr bool is_vector_v = is_vector<std::decay_t<T>>::value;
+
+}
+
+
+/// ======================================
+/// implementation
+
+/// Vector impl
+namespace matlib {
+
+template<typename V>
+Vector<V>::Vector(Size_T N, const V* raw_data) {
+    if (nullptr == raw_data) {
+        this->data = std::vector<V> (N, V{});
+    } else {
+        this->data = std::vector<V> (raw_data, raw_data + N);
+    }
+}
+
+template<typename V>
+Size_T Vector<V>::size() const {
+    return data.size();
+}
+
+template<typename V>
+Size_T Vector<V>::stride() const {
+    return 1;
+}
+
+template<typename V>
+V* Vector<V>::raw_data() {
+    return data.data();
+}
+
+template<typename V>
+const V* Vector<V>::raw_data() const {
+    return data.data();
+}
+
+template<typename V>
+V& Vector<V>::unsafe_at(Size_T i) {
+    return data[i];
+}
+
+template<typename V>
+const V& Vector<V>::unsafe_at(Size_T i) const {
+    return data[i];
+}
+
+template<typename V>
+V& Vector<V>::at(Size_T i) {
+    MATLIB_CHECK(V, Full, i < data.size(), "Bad index.");
+    return data[i];
+}
+
+template<typename V>
+const V& Vector<V>::at(Size_T i) const {
+    MATLIB_CHECK(V, Full, i < data.size(), "Bad index.");
+    return data[i];
+}
+
+template<typename V>
+typename Vector<V>::RawIterator Vector<V>::raw_begin() {
+    return data.begin();
+}
+
+template<typename V>
+typename Vector<V>::RawIterator Vector<V>::raw_end() {
+    return data.end();
+}
+
+template<typename V>
+typename Vector<V>::ConstRawIterator Vector<V>::raw_const_begin() const {
+    return data.begin();
+}
+
+template<typename V>
+typename Vector<V>::ConstRawIterator Vector<V>::raw_const_end() const {
+    return data.end();
+}
+
+template<typename V>
+Matrix<V> Vector<V>::to_mat() const {
+    Matrix<V> retval (data.size(), 1);
+    std::copy(data.begin(), data.end(), retval.raw_begin());
+    return retval;
+}
+
+}
+/// VectorView impl
+namespace matlib {
+
+template<typename V, typename MatType>
+VectorView<V, MatType>::VectorView(ElementTypePtr base_, Size_T length_, Size_T step_)
+    : base(base_), length(length_), step(step_) {}
+
+template<typename V, typename MatType>
+Size_T VectorView<V, MatType>::size() const {
+    return length;
+}
+
+template<typename V, typename MatType>
+Size_T VectorView<V, MatType>::stride() const {
+    return step;
+}
+
+template<typename V, typename MatType>
+typename VectorView<V, MatType>::ElementTypePtr VectorView<V, MatType>::raw_data() const {
+    return base;
+}
+
+template<typename V, typename MatType>
+typename VectorView<V, MatType>::ElementTypeRef VectorView<V, MatType>::at(Size_T i) const {
+    MATLIB_CHECK(V, Full, i < length, "Bad index out of view.");
+    return base[i * step];
+}
+
+template<typename V, typename MatType>
+typename VectorView<V, MatType>::ElementTypeRef VectorView<V, MatType>::unsafe_at(Size_T i) const {
+    return base[i * step];
+}
+
+template<typename V, typename MatType>
+VectorView<V, MatType> VectorView<V, MatType>::slice(Size_T a, Size_T b) const {
+    Range range {a, b};
+    MATLIB_CHECK(V, Assert, range.b < length, "Slice out of range of view.");
+    return VectorView<V, MatType> (base + range.a * step, range.b - range.a + 1, step);
+}
+
+template<typename V, typename MatType>
+Vector<V> VectorView<V, MatType>::to_vec() const {
+    Vector<V> retval (length);
+    auto p_ret = retval.raw_data();
+    for (Size_T i = 0; i < length; ++i) {
+        p_ret[i] = base[i * step];
+    }
+    return retval;
+}
+
+}
@@ -6,12 +6,20 @@
 
 using namespace matlib;
 
+// matrices of int skip every check, whatever the build default
+template<>
+struct matlib::CheckPolicy<int> {
+    static constexpr Check level = Check::None;
+};
+
 void create_test();
 void access_test();
+void policy_test();
 
 int main() {
     create_test();
     access_test();
+    policy_test();
 
     return 0;
 }
@@ -41,3 +49,14 @@ void access_test() {
     mat1.at(1, 1) = 4;
     ASSERT_EQ(mat1.at(1, 1), mat2.at(0, 3));
 }
+
+void policy_test() {
+    static_assert(CheckPolicy<float>::level == default_check);
+    static_assert(CheckPolicy<int>::level == Check::None);
+
+    int raw_data[] = {1, 2, 3, 4};
+    Matrix<int> mat(2, 2, raw_data);
+    // column index past the row, still inside the storage: unchecked
+    ASSERT_EQ(mat.at(0, 3), 4);
+    ASSERT_EQ(&mat.unsafe_at(1, 1), mat.raw_data() + 3);
+}
@@ -0,0 +1,143 @@
+// std
+#include <cmath>
+#include <limits>
+#include <random>
+// matlib
+#include "mat.hpp"
+
+using namespace matlib;
+
+void QR_shape_test();
+void QR_small_test();
+void cholesky_test();
+void least_squares_test();
+void spd_solve_test();
+
+int main() {
+    QR_shape_test();
+    QR_small_test();
+    cholesky_test();
+    least_squares_test();
+    spd_solve_test();
+
+    return 0;
+}
+
+namespace {
+
+Matrix<double> random_matrix(Size_T NR, Size_T NC, std::mt19937 &rng) {
+    std::uniform_real_distribution<double> dist (-1., 1.);
+    Matrix<double> retval (NR, NC);
+    for (auto it = retval.raw_begin(); it != retval.raw_end(); ++it) {
+        *it = dist(rng);
+    }
+    return retval;
+}
+
+Matrix<double> spd_matrix(Size_T N, std::mt19937 &rng) {
+    auto G = random_matrix(N, N, rng);
+    auto retval = G * G.transpose();
+    for (Size_T i = 0; i < N; ++i) {
+        retval.at(i, i) += 1.;
+    }
+    return retval;
+}
+
+Matrix<double> identity(Size_T N) {
+    Matrix<double> retval (N, N);
+    for (Size_T i = 0; i < N; ++i) {
+        retval.at(i, i) = 1.;
+    }
+    return retval;
+}
+
+}
+
+// sizes straddle the panel width so partial panels and wide inputs are hit
+void QR_shape_test() {
+    std::mt19937 rng (1);
+    Size_T sizes[][2] = {{1, 1}, {5, 3}, {3, 5}, {33, 33}, {70, 40}, {40, 70}, {100, 65}, {129, 97}};
+    for (auto &mn : sizes) {
+        auto A = random_matrix(mn[0], mn[1], rng);
+        auto [Q, R] = QR_decomposite(A);
+        Size_T k = std::min(mn[0], mn[1]);
+        ASSERT_EQ(Q.get_shape(), std::make_pair(mn[0], k));
+        ASSERT_EQ(R.get_shape(), std::make_pair(k, mn[1]));
+        for (Size_T i = 0; i < k; ++i) {
+            for (Size_T j = 0; j < i; ++j) {
+                ASSERT_EQ(R.at(i, j), 0.);
+            }
+        }
+        ASSERT_MSG(norm_fro(Q * R - A) < 1e-12 * static_cast<double>(mn[0] * mn[1]),
+            "QR does not reconstruct A.");
+        ASSERT_MSG(norm_fro(Q.transpose() * Q - identity(k)) < 1e-12 * static_cast<double>(mn[0]),
+            "Q is not orthonormal.");
+    }
+}
+
+void QR_small_test() {
+    float data[] = {
+        3, 0,
+        4, 5,
+    };
+    Matrix<float> A (2, 2, data);
+    auto [Q, R] = QR_decomposite(A);
+    // |R[0, 0]| is the norm of the first column
+    ASSERT_MSG(std::abs(std::abs(R.at(0, 0)) - 5.f) < 1e-6f, "Bad first pivot.");
+    ASSERT_MSG(norm_fro(Q * R - A) < 1e-5f, "QR does not reconstruct A.");
+}
+
+void cholesky_test() {
+    std::mt19937 rng (2);
+    for (Size_T N : {1, 7, 64, 65, 150}) {
+        auto A = spd_matrix(N, rng);
+        // the upper triangle must never be read
+        auto lower = A;
+        for (Size_T i = 0; i < N; ++i) {
+            for (Size_T j = i + 1; j < N; ++j) {
+                lower.at(i, j) = std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+        auto L = cholesky_decomposite(lower);
+        for (Size_T i = 0; i < N; ++i) {
+            ASSERT_MSG(L.at(i, i) > 0., "Diagonal of L must be positive.");
+            for (Size_T j = i + 1; j < N; ++j) {
+                ASSERT_EQ(L.at(i, j), 0.);
+            }
+        }
+        ASSERT_MSG(norm_fro(L * L.transpose() - A) < 1e-10 * static_cast<double>(N * N),
+            "Cholesky does not reconstruct A.");
+    }
+}
+
+void least_squares_test() {
+    std::mt19937 rng (3);
+    // consistent system, the exact solution must come back
+    auto A = random_matrix(120, 50, rng);
+    auto X = random_matrix(50, 3, rng);
+    auto B = A * X;
+    ASSERT_MSG(norm_fro(least_squares(A, B) - X) < 1e-10, "Least squares misses exact solution.");
+    // inconsistent system, the residual is orthogonal to range(A)
+    Vector<double> b (120);
+    for (Size_T i = 0; i < 120; ++i) {
+        b.at(i) = std::sin(static_cast<double>(i));
+    }
+    auto x = least_squares(A, b);
+    ASSERT_EQ(x.size(), static_cast<Size_T>(50));
+    Vector<double> r = A * x - b;
+    Vector<double> g = r * A;
+    ASSERT_MSG(nrm2(g) < 1e-10 * nrm2(b) * norm_fro(A), "Residual not orthogonal to range(A).");
+}
+
+void spd_solve_test() {
+    std::mt19937 rng (4);
+    auto A = spd_matrix(90, rng);
+    auto X = random_matrix(90, 4, rng);
+    ASSERT_MSG(norm_fro(spd_solve(A, A * X) - X) < 1e-8, "SPD solve is inaccurate.");
+    Vector<double> b (90);
+    for (Size_T i = 0; i < 90; ++i) {
+        b.at(i) = 1.;
+    }
+    auto x = spd_solve(A, b);
+    ASSERT_MSG(nrm2(A * x - b) < 1e-10 * norm_fro(A) * nrm2(x), "SPD residual too large.");
+}
@@ -0,0 +1,127 @@
+// std
+#include <cstdio>
+#include <string>
+// matlib
+#include "mat.hpp"
+
+using namespace matlib;
+
+void csv_parse_test();
+void csv_round_trip_test();
+void mtx_parse_test();
+void mtx_round_trip_test();
+void threaded_test();
+
+int main() {
+    csv_parse_test();
+    csv_round_trip_test();
+    mtx_parse_test();
+    mtx_round_trip_test();
+    threaded_test();
+
+    return 0;
+}
+
+void csv_parse_test() {
+    float data[] = {1,2,3,-4.5,5e2,6};
+    Matrix<float> expect (2, 3, data);
+
+    ASSERT_EQ(parse_csv<float>("1,2,3\n-4.5,5e2,6\n"), expect);
+    // blank lines, CRLF, padding, explicit sign, no final newline
+    ASSERT_EQ(parse_csv<float>("\n1, 2 ,+3\r\n\n-4.5,500,6"), expect);
+    ASSERT_EQ(parse_csv<float>("1;2;3\n-4.5;500;6\n", ';'), expect);
+
+    auto empty = parse_csv<float>("\n\n");
+    ASSERT_EQ(empty.get_shape().first, 0);
+}
+
+void csv_round_trip_test() {
+    double data[] = {0.1, -1.0 / 3, 1e-300, 12345678.9, 0, 2.5e10};
+    Matrix<double> mat (3, 2, data);
+    const char *path = "io_test.csv";
+
+    write_csv(path, mat);
+    // shortest round-trip formatting reproduces every bit
+    auto back = read_csv<double>(path);
+    std::remove(path);
+    ASSERT_EQ(back.get_shape(), mat.get_shape());
+    for (Size_T i = 0; i < 6; ++i) {
+        ASSERT_EQ(back.raw_data()[i], data[i]);
+    }
+}
+
+void mtx_parse_test() {
+    std::string coordinate =
+        "%%MatrixMarket matrix coordinate real general\n"
+        "% a comment\n"
+        "2 3 3\n"
+        "1 1 1.5\n"
+        "2 3 -2\n"
+        "1 2 4\n";
+    float data1[] = {1.5,4,0,0,0,-2};
+    ASSERT_EQ(parse_matrix_market<float>(coordinate), Matrix<float>(2, 3, data1));
+
+    std::string symmetric =
+        "%%MatrixMarket matrix coordinate integer symmetric\n"
+        "3 3 3\n"
+        "1 1 1\n"
+        "3 1 2\n"
+        "3 2 3\n";
+    int data2[] = {1,0,2,0,0,3,2,3,0};
+    ASSERT_EQ(parse_matrix_market<int>(symmetric), Matrix<int>(3, 3, data2));
+
+    std::string pattern =
+        "%%MatrixMarket matrix coordinate pattern skew-symmetric\n"
+        "2 2 1\n"
+        "2 1\n";
+    int data3[] = {0,-1,1,0};
+    ASSERT_EQ(parse_matrix_market<int>(pattern), Matrix<int>(2, 2, data3));
+
+    std::string array =
+        "%%MatrixMarket matrix array real general\n"
+        "2 3\n"
+        "1\n4\n2\n5\n3\n6\n";
+    float data4[] = {1,2,3,4,5,6};
+    ASSERT_EQ(parse_matrix_market<float>(array), Matrix<float>(2, 3, data4));
+
+    std::string array_symmetric =
+        "%%MatrixMarket matrix array real symmetric\n"
+        "3 3\n"
+        "1\n2\n3\n4\n5\n6\n";
+    float data5[] = {1,2,3,2,4,5,3,5,6};
+    ASSERT_EQ(parse_matrix_market<float>(array_symmetric), Matrix<float>(3, 3, data5));
+}
+
+void mtx_round_trip_test() {
+    double data[] = {0, 1.25, 0, -7, 0, 1e-12};
+    Matrix<double> mat (2, 3, data);
+    const char *path = "io_test.mtx";
+
+    write_matrix_market(path, mat);
+    ASSERT_EQ(read_matrix_market<double>(path), mat);
+    write_matrix_market(path, mat, MMFormat::Array);
+    ASSERT_EQ(read_matrix_market<double>(path), mat);
+    std::remove(path);
+}
+
+void threaded_test() {
+    set_num_threads(4);
+    // several megabytes so the input splits into many chunks
+    Size_T NR = 40000, NC = 16;
+    std::string text;
+    for (Size_T i = 0; i < NR; ++i) {
+        for (Size_T j = 0; j < NC; ++j) {
+            text += std::to_string((i * NC + j) % 1000) + (j + 1 < NC ? "," : "\n");
+        }
+        if (i % 1000 == 0) {
+            text += "\n";
+        }
+    }
+    auto mat = parse_csv<int>(text);
+    ASSERT_EQ(mat.get_shape().first, NR);
+    ASSERT_EQ(mat.get_shape().second, NC);
+    for (Size_T i = 0; i < NR * NC; ++i) {
+        ASSERT_EQ(mat.raw_data()[i], static_cast<int>(i % 1000));
+    }
+    set_num_threads(0);
+}
@@ -0,0 +1,190 @@
+// std
+#include <cmath>
+#include <random>
+// matlib
+#include "mat.hpp"
+
+using namespace matlib;
+
+void rank_one_test();
+void rank_k_test();
+void replace_test();
+void append_remove_test();
+void drift_test();
+
+int main() {
+    rank_one_test();
+    rank_k_test();
+    replace_test();
+    append_remove_test();
+    drift_test();
+
+    return 0;
+}
+
+namespace {
+
+Matrix<double> random_matrix(Size_T NR, Size_T NC, std::mt19937 &rng) {
+    std::uniform_real_distribution<double> dist (-1., 1.);
+    Matrix<double> retval (NR, NC);
+    for (auto it = retval.raw_begin(); it != retval.raw_end(); ++it) {
+        *it = dist(rng);
+    }
+    return retval;
+}
+
+Vector<double> random_vector(Size_T N, std::mt19937 &rng) {
+    std::uniform_real_distribution<double> dist (-1., 1.);
+    Vector<double> retval (N);
+    for (Size_T i = 0; i < N; ++i) {
+        retval.at(i) = dist(rng);
+    }
+    return retval;
+}
+
+// diagonally dominant, so updates keep it well conditioned
+Matrix<double> dominant_matrix(Size_T N, std::mt19937 &rng) {
+    auto retval = random_matrix(N, N, rng);
+    for (Size_T i = 0; i < N; ++i) {
+        retval.at(i, i) += static_cast<double>(N);
+    }
+    return retval;
+}
+
+// the solve must agree with the tracked matrix
+void check_solve(const UpdatableLU<double> &lu, const Matrix<double> &expect, std::mt19937 &rng) {
+    ASSERT_EQ(lu.size(), expect.get_shape().first);
+    ASSERT_MSG(norm_inf(lu.matrix() - expect) < 1e-12, "Tracked matrix drifted.");
+    auto b = random_vector(lu.size(), rng);
+    auto x = lu.solve(b);
+    ASSERT_MSG(norm_inf(expect * x - b) < 1e-9, "Solve does not match the matrix.");
+}
+
+}
+
+void rank_one_test() {
+    std::mt19937 rng (1);
+    auto A = dominant_matrix(40, rng);
+    UpdatableLU<double> lu (A);
+    check_solve(lu, A, rng);
+    for (int t = 0; t < 10; ++t) {
+        auto x = random_vector(40, rng), y = random_vector(40, rng);
+        lu.rank_one_update(x, y);
+        A = A + x.to_mat() * y.to_mat().transpose();
+        check_solve(lu, A, rng);
+    }
+    ASSERT_EQ(lu.refactor_count(), static_cast<Size_T>(0));
+    ASSERT_MSG(lu.drift() < lu.drift_tolerance(), "Drift should stay small.");
+}
+
+void rank_k_test() {
+    std::mt19937 rng (2);
+    auto A = dominant_matrix(30, rng);
+    UpdatableLU<double> lu (A);
+    auto X = random_matrix(30, 3, rng), Y = random_matrix(30, 3, rng);
+    lu.rank_k_update(X, Y);
+    A = A + X * Y.transpose();
+    check_solve(lu, A, rng);
+}
+
+void replace_test() {
+    std::mt19937 rng (3);
+    auto A = dominant_matrix(25, rng);
+    UpdatableLU<double> lu (A);
+    auto row = random_vector(25, rng), col = random_vector(25, rng);
+    row.at(4) = 30.;
+    col.at(9) = 30.;
+    lu.replace_row(4, row);
+    lu.replace_col(9, col);
+    for (Size_T j = 0; j < 25; ++j) {
+        A.at(4, j) = row.at(j);
+    }
+    for (Size_T i = 0; i < 25; ++i) {
+        A.at(i, 9) = col.at(i);
+    }
+    check_solve(lu, A, rng);
+}
+
+void append_remove_test() {
+    std::mt19937 rng (4);
+    auto A = dominant_matrix(20, rng);
+    UpdatableLU<double> lu (A);
+    // grow by one row and column
+    auto row = random_vector(20, rng), col = random_vector(20, rng);
+    lu.append(row, col, 25.);
+    Matrix<double> B (21, 21);
+    for (Size_T i = 0; i < 20; ++i) {
+        for (Size_T j = 0; j < 20; ++j) {
+            B.at(i, j) = A.at(i, j);
+        }
+        B.at(20, i) = row.at(i);
+        B.at(i, 20) = col.at(i);
+    }
+    B.at(20, 20) = 25.;
+    check_solve(lu, B, rng);
+    // drop index 7, then the rest must still solve
+    lu.remove(7);
+    Matrix<double> C (20, 20);
+    for (Size_T i = 0, ci = 0; i < 21; ++i) {
+        if (i == 7) {
+            continue;
+        }
+        for (Size_T j = 0, cj = 0; j < 21; ++j) {
+            if (j == 7) {
+                continue;
+            }
+            C.at(ci, cj++) = B.at(i, j);
+        }
+        ++ci;
+    }
+    check_solve(lu, C, rng);
+    // append after a removal, then compact
+    auto row2 = random_vector(20, rng), col2 = random_vector(20, rng);
+    lu.append(row2, col2, 30.);
+    Matrix<double> D (21, 21);
+    for (Size_T i = 0; i < 20; ++i) {
+        for (Size_T j = 0; j < 20; ++j) {
+            D.at(i, j) = C.at(i, j);
+        }
+        D.at(20, i) = row2.at(i);
+        D.at(i, 20) = col2.at(i);
+    }
+    D.at(20, 20) = 30.;
+    check_solve(lu, D, rng);
+    auto count = lu.refactor_count();
+    lu.refactor();
+    ASSERT_EQ(lu.refactor_count(), count + 1);
+    check_solve(lu, D, rng);
+}
+
+// an update that zeroes the leading pivot breaks Bennett's recurrence,
+// the monitor must notice and refactor with pivoting
+void drift_test() {
+    float data[] = {
+        1, 2, 0,
+        3, 4, 1,
+        0, 1, 5,
+    };
+    Matrix<double> A (3, 3);
+    for (Size_T i = 0; i < 9; ++i) {
+        A.at(i / 3, i % 3) = data[i];
+    }
+    UpdatableLU<double> lu (A);
+    ASSERT_EQ(lu.refactor_count(), static_cast<Size_T>(0));
+    // the pivot row is [3, 4, 1], make its leading entry vanish
+    Vector<double> row (3);
+    row.at(0) = 0., row.at(1) = 4., row.at(2) = 1.;
+    lu.replace_row(1, row);
+    A.at(1, 0) = 0.;
+    ASSERT_EQ(lu.refactor_count(), static_cast<Size_T>(1));
+    std::mt19937 rng (5);
+    check_solve(lu, A, rng);
+    // a negative tolerance refactors after every update
+    lu.set_drift_tolerance(-1.);
+    Vector<double> x (3), y (3);
+    x.at(0) = 1., y.at(2) = 1.;
+    lu.rank_one_update(x, y);
+    A.at(0, 2) += 1.;
+    ASSERT_EQ(lu.refactor_count(), static_cast<Size_T>(2));
+    check_solve(lu, A, rng);
+}
@@ -0,0 +1,133 @@
+// std
+#include <cmath>
+// matlib
+#include "mat.hpp"
+
+using namespace matlib;
+
+void sum_test();
+void norm_test();
+void min_max_test();
+void argmax_abs_test();
+void any_all_test();
+void threaded_test();
+
+int main() {
+    sum_test();
+    norm_test();
+    min_max_test();
+    argmax_abs_test();
+    any_all_test();
+    threaded_test();
+
+    return 0;
+}
+
+void sum_test() {
+    float data[] = {1,2,3,4,5,6,7,8,9};
+    Matrix<float> mat (3, 3, data);
+
+    ASSERT_EQ(sum(mat), 45);
+    ASSERT_EQ(sum(mat, Summation::Kahan), 45);
+    ASSERT_EQ(sum(mat.row(1)), 15);
+    ASSERT_EQ(sum(mat.col(1)), 15);
+    ASSERT_EQ(sum(mat.slice(1, 2, 1, 2)), 28);
+    ASSERT_EQ(sum(mat.slice(1, 2, 1, 2), Summation::Kahan), 28);
+
+    // 1 followed by many values below half an ulp of 1
+    Size_T n = 1 << 20;
+    Vector<float> v (n + 1);
+    v.at(0) = 1;
+    for (Size_T i = 1; i <= n; ++i) {
+        v.at(i) = 1e-8f;
+    }
+    float expect = 1.f + static_cast<float>(n) * 1e-8f;
+    ASSERT_MSG(std::abs(sum(v, Summation::Kahan) - expect) < 1e-6f, "Kahan sum");
+    ASSERT_MSG(std::abs(sum(v) - expect) < 1e-6f, "pairwise sum");
+}
+
+void norm_test() {
+    float data[] = {1,-2,3,-4};
+    Matrix<float> mat (2, 2, data);
+
+    ASSERT_MSG(ValueEq(norm_fro(mat), std::sqrt(30.f)), "frobenius norm");
+    ASSERT_EQ(norm_1(mat), 6);
+    ASSERT_EQ(norm_inf(mat), 7);
+
+    ASSERT_EQ(norm_1(mat.col(1)), 6);
+    ASSERT_EQ(norm_inf(mat.col(1)), 4);
+    ASSERT_MSG(ValueEq(norm_fro(mat.col(1)), std::sqrt(20.f)), "vector norm");
+
+    float data2[] = {1,2,3,4,5,6,7,8,9};
+    Matrix<float> mat2 (3, 3, data2);
+    auto sub = mat2.slice(0, 1, 1, 2);
+    ASSERT_MSG(ValueEq(norm_fro(sub), std::sqrt(4.f + 9 + 25 + 36)), "slice norm");
+    ASSERT_EQ(norm_1(sub), 9);
+    ASSERT_EQ(norm_inf(sub), 11);
+}
+
+void min_max_test() {
+    float data[] = {3,-1,4,1,-5,9,2,6,5,3,5};
+    Vector<float> v (11, data);
+
+    ASSERT_EQ(min(v), -5);
+    ASSERT_EQ(max(v), 9);
+
+    Matrix<float> mat (1, 11, data);
+    ASSERT_EQ(min(mat.slice(0, 0, 5, 10)), 2);
+    ASSERT_EQ(max(mat.slice(0, 0, 0, 4)), 4);
+}
+
+void argmax_abs_test() {
+    float data[] = {1,-7,3,7,-2,0};
+    Vector<float> v (6, data);
+    ASSERT_EQ(argmax_abs(v), 1);
+
+    Matrix<float> mat (2, 3, data);
+    auto idx = argmax_abs(mat);
+    ASSERT_EQ(idx.first, 0);
+    ASSERT_EQ(idx.second, 1);
+    ASSERT_EQ(argmax_abs(mat.col(0)), 1);
+    auto sub_idx = argmax_abs(mat.slice(0, 1, 2, 2));
+    ASSERT_EQ(sub_idx.first, 0);
+    ASSERT_EQ(sub_idx.second, 0);
+}
+
+void any_all_test() {
+    float data[] = {0,1,2,0};
+    Matrix<float> mat (2, 2, data);
+
+    ASSERT_EQ(any(mat), true);
+    ASSERT_EQ(all(mat), false);
+    ASSERT_EQ(all(mat.row(0).slice(1, 1)), true);
+    ASSERT_EQ(any(mat.col(1)), true);
+    ASSERT_EQ(all(mat, [](float x) { return x < 3; }), true);
+    ASSERT_EQ(any(mat, [](float x) { return x < 0; }), false);
+}
+
+void threaded_test() {
+    set_num_threads(4);
+    Size_T n = 1000;
+    Matrix<double> mat (n, n);
+    for (Size_T i = 0; i < n; ++i) {
+        for (Size_T j = 0; j < n; ++j) {
+            mat.at(i, j) = static_cast<double>((i * 7 + j) % 13) - 6;
+        }
+    }
+    mat.at(617, 283) = -100;
+
+    double expect = 0;
+    for (Size_T i = 0; i < n; ++i) {
+        for (Size_T j = 0; j < n; ++j) {
+            expect += mat.at(i, j);
+        }
+    }
+    ASSERT_EQ(sum(mat), expect);
+    ASSERT_EQ(sum(mat.slice(0, n - 1, 0, n - 1)), expect);
+    ASSERT_EQ(min(mat), -100);
+
+    auto idx = argmax_abs(mat);
+    ASSERT_EQ(idx.first, 617);
+    ASSERT_EQ(idx.second, 283);
+    set_num_threads(0);
+}
@@ -0,0 +1,131 @@
+// std
+#include <cmath>
+#include <random>
+#include <vector>
+// matlib
+#include "mat.hpp"
+
+using namespace matlib;
+
+void exact_shape_test();
+void error_bound_test();
+void workspace_test();
+void auto_select_test();
+
+int main() {
+    exact_shape_test();
+    error_bound_test();
+    workspace_test();
+    auto_select_test();
+
+    return 0;
+}
+
+namespace {
+
+template<typename V>
+Matrix<V> random_matrix(Size_T NR, Size_T NC, std::mt19937 &rng) {
+    std::uniform_int_distribution<int> dist (-9, 9);
+    Matrix<V> retval (NR, NC);
+    for (auto it = retval.raw_begin(); it != retval.raw_end(); ++it) {
+        *it = static_cast<V>(dist(rng));
+    }
+    return retval;
+}
+
+// reference product without the library kernels
+template<typename V>
+Matrix<V> naive_multiply(const Matrix<V> &lhs, const Matrix<V> &rhs) {
+    auto m = lhs.get_shape().first, k = lhs.get_shape().second, n = rhs.get_shape().second;
+    Matrix<V> retval (m, n);
+    for (Size_T i = 0; i < m; ++i) {
+        for (Size_T j = 0; j < n; ++j) {
+            V cur{};
+            for (Size_T p = 0; p < k; ++p) {
+                cur += lhs.at(i, p) * rhs.at(p, j);
+            }
+            retval.at(i, j) = cur;
+        }
+    }
+    return retval;
+}
+
+}
+
+// integer products are exact, so every peeling path must match exactly
+void exact_shape_test() {
+    std::mt19937 rng (1);
+    Size_T sizes[] = {1, 2, 3, 4, 5, 7, 8, 9, 16, 17, 31};
+    for (Size_T m : sizes) {
+        for (Size_T k : sizes) {
+            for (Size_T n : sizes) {
+                auto A = random_matrix<long long>(m, k, rng);
+                auto B = random_matrix<long long>(k, n, rng);
+                ASSERT_EQ(strassen_multiply(A, B, 1), naive_multiply(A, B));
+            }
+        }
+    }
+}
+
+// Higham, Accuracy and Stability of Numerical Algorithms, 2nd ed., sec.
+// 23.2.2: for Winograd's variant with n = 2^k n0 the computed product
+// satisfies
+//   max|C - C^| <= [(n / n0)^log2(18) (n0^2 + 6 n0) - 6 n] u max|A| max|B|
+// to first order, against n u max|A| max|B| for the classical product.
+// The measured error is normally orders of magnitude below the bound.
+void error_bound_test() {
+    std::mt19937 rng (2);
+    std::uniform_real_distribution<double> dist (-1, 1);
+    for (Size_T n : {128, 300}) {
+        Size_T n0 = 16;
+        Matrix<double> A (n, n), B (n, n);
+        for (auto it = A.raw_begin(); it != A.raw_end(); ++it) {
+            *it = dist(rng);
+        }
+        for (auto it = B.raw_begin(); it != B.raw_end(); ++it) {
+            *it = dist(rng);
+        }
+        auto exact = naive_multiply(A, B);
+        auto C = strassen_multiply(A, B, n0);
+
+        double u = std::numeric_limits<double>::epsilon() / 2;
+        double ratio = static_cast<double>(n) / static_cast<double>(n0);
+        double factor = std::pow(ratio, std::log2(18.0)) * static_cast<double>(n0 * n0 + 6 * n0)
+            - 6.0 * static_cast<double>(n);
+        double bound = factor * u * norm_inf(Vector<double>(n * n, A.raw_data()))
+            * norm_inf(Vector<double>(n * n, B.raw_data()));
+        double error = norm_inf(Vector<double>(n * n, (C - exact).raw_data()));
+        ASSERT_MSG(error <= bound, "Strassen-Winograd error above the bound.");
+    }
+}
+
+void workspace_test() {
+    std::mt19937 rng (3);
+    auto A = random_matrix<long long>(70, 45, rng);
+    auto B = random_matrix<long long>(45, 33, rng);
+    std::vector<long long> workspace;
+
+    auto C1 = strassen_multiply(A, B, workspace, 4);
+    Size_T need = strassen_workspace_size(70, 45, 33, 4);
+    ASSERT_EQ(workspace.size(), need);
+    // bound from the doc comment
+    ASSERT_MSG(need <= (70 * 45 + 45 * 33) / 3, "Workspace above its bound.");
+    auto C2 = strassen_multiply(A, B, workspace, 4);
+    ASSERT_EQ(workspace.size(), need);
+    ASSERT_EQ(C1, C2);
+    ASSERT_EQ(C1, naive_multiply(A, B));
+}
+
+void auto_select_test() {
+    std::mt19937 rng (4);
+    auto A = random_matrix<long long>(65, 80, rng);
+    auto B = random_matrix<long long>(80, 67, rng);
+    auto expect = naive_multiply(A, B);
+
+    Size_T saved = get_strassen_threshold();
+    set_strassen_threshold(64);
+    ASSERT_EQ(A * B, expect);
+    set_strassen_threshold(0);
+    ASSERT_EQ(A * B, expect);
+    set_strassen_threshold(saved);
+}
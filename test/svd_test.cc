@@ -0,0 +1,162 @@
+// std
+#include <cmath>
+#include <random>
+// matlib
+#include "mat.hpp"
+
+using namespace matlib;
+
+void exact_svd_test();
+void low_rank_test();
+void power_iteration_test();
+void streaming_test();
+
+int main() {
+    exact_svd_test();
+    low_rank_test();
+    power_iteration_test();
+    streaming_test();
+
+    return 0;
+}
+
+namespace {
+
+Matrix<double> random_matrix(Size_T NR, Size_T NC, std::mt19937 &rng) {
+    std::uniform_real_distribution<double> dist (-1., 1.);
+    Matrix<double> retval (NR, NC);
+    for (auto it = retval.raw_begin(); it != retval.raw_end(); ++it) {
+        *it = dist(rng);
+    }
+    return retval;
+}
+
+// U diag(s) Vt
+Matrix<double> compose(const Matrix<double> &U, const Vector<double> &S, const Matrix<double> &Vt) {
+    auto US = U;
+    for (Size_T i = 0; i < US.get_shape().first; ++i) {
+        for (Size_T j = 0; j < S.size(); ++j) {
+            US.at(i, j) *= S.at(j);
+        }
+    }
+    return US * Vt;
+}
+
+// A with singular values sigma(i) and random singular vectors
+template<typename F>
+Matrix<double> spectrum_matrix(Size_T m, Size_T n, F &&sigma, std::mt19937 &rng) {
+    auto U = std::get<0>(QR_decomposite(random_matrix(m, n, rng)));
+    auto W = std::get<0>(QR_decomposite(random_matrix(n, n, rng)));
+    Vector<double> S (n);
+    for (Size_T i = 0; i < n; ++i) {
+        S.at(i) = sigma(i);
+    }
+    return compose(U, S, W.transpose());
+}
+
+// best possible rank-k error in Frobenius norm
+double tail_norm(const Vector<double> &S, Size_T k) {
+    double acc = 0;
+    for (Size_T i = k; i < S.size(); ++i) {
+        acc += S.at(i) * S.at(i);
+    }
+    return std::sqrt(acc);
+}
+
+Matrix<double> identity(Size_T N) {
+    Matrix<double> retval (N, N);
+    for (Size_T i = 0; i < N; ++i) {
+        retval.at(i, i) = 1.;
+    }
+    return retval;
+}
+
+}
+
+void exact_svd_test() {
+    std::mt19937 rng (1);
+    Size_T shapes[][2] = {{1, 1}, {4, 9}, {9, 4}, {30, 30}};
+    for (auto &mn : shapes) {
+        auto A = random_matrix(mn[0], mn[1], rng);
+        auto [U, S, Vt] = SVD_decomposite(A);
+        Size_T k = std::min(mn[0], mn[1]);
+        ASSERT_EQ(S.size(), k);
+        for (Size_T i = 1; i < k; ++i) {
+            ASSERT_MSG(S.at(i - 1) >= S.at(i), "Singular values must descend.");
+        }
+        ASSERT_MSG(norm_fro(compose(U, S, Vt) - A) < 1e-12 * static_cast<double>(mn[0] * mn[1]),
+            "SVD does not reconstruct A.");
+        ASSERT_MSG(norm_fro(U.transpose() * U - identity(k)) < 1e-12 * static_cast<double>(k),
+            "U is not orthonormal.");
+        ASSERT_MSG(norm_fro(Vt * Vt.transpose() - identity(k)) < 1e-12 * static_cast<double>(k),
+            "V is not orthonormal.");
+    }
+    // known spectrum
+    float data[] = {
+        3, 0,
+        0, -4,
+    };
+    Matrix<double> D (2, 2);
+    for (Size_T i = 0; i < 4; ++i) {
+        D.at(i / 2, i % 2) = data[i];
+    }
+    auto S = std::get<1>(SVD_decomposite(D));
+    ASSERT_MSG(std::abs(S.at(0) - 4.) < 1e-14 && std::abs(S.at(1) - 3.) < 1e-14, "Bad singular values.");
+}
+
+// an exactly rank-k matrix is recovered to rounding
+void low_rank_test() {
+    std::mt19937 rng (2);
+    auto A = random_matrix(120, 8, rng) * random_matrix(8, 90, rng);
+    auto [U, S, Vt] = randomized_svd(A, 8, 5, 0);
+    ASSERT_EQ(U.get_shape(), std::make_pair(Size_T{120}, Size_T{8}));
+    ASSERT_EQ(Vt.get_shape(), std::make_pair(Size_T{8}, Size_T{90}));
+    ASSERT_MSG(norm_fro(compose(U, S, Vt) - A) < 1e-10 * norm_fro(A), "Rank-8 matrix not recovered.");
+    auto S_exact = std::get<1>(SVD_decomposite(A));
+    for (Size_T i = 0; i < 8; ++i) {
+        ASSERT_MSG(std::abs(S.at(i) - S_exact.at(i)) < 1e-10 * S_exact.at(0), "Singular value mismatch.");
+    }
+}
+
+// a slowly decaying spectrum: power iterations close the gap to optimal
+void power_iteration_test() {
+    std::mt19937 rng (3);
+    auto A = spectrum_matrix(150, 100, [](Size_T i) { return 1. / (1. + static_cast<double>(i)); }, rng);
+    auto S_exact = std::get<1>(SVD_decomposite(A));
+    double best = tail_norm(S_exact, 10);
+    auto error = [&](Size_T q) {
+        auto [U, S, Vt] = randomized_svd(A, 10, 10, q, 7);
+        return norm_fro(compose(U, S, Vt) - A);
+    };
+    double e0 = error(0), e2 = error(2);
+    ASSERT_MSG(e2 <= e0, "Power iterations should not hurt.");
+    ASSERT_MSG(e2 < 1.05 * best, "Power iterations should come close to optimal.");
+    ASSERT_MSG(e0 < 2. * best, "Plain range finder is far from optimal.");
+}
+
+void streaming_test() {
+    std::mt19937 rng (4);
+    auto A = spectrum_matrix(200, 60, [](Size_T i) { return std::pow(0.5, static_cast<double>(i)); }, rng);
+    StreamingSVD<double> sketch (60, 6, 10, 3);
+    // uneven row blocks
+    for (Size_T b = 0; b < 200;) {
+        Size_T e = std::min<Size_T>(200, b + 17 + b % 13);
+        Matrix<double> block (e - b, 60);
+        for (Size_T i = b; i < e; ++i) {
+            for (Size_T j = 0; j < 60; ++j) {
+                block.at(i - b, j) = A.at(i, j);
+            }
+        }
+        sketch.push_rows(block);
+        b = e;
+    }
+    ASSERT_EQ(sketch.rows(), Size_T{200});
+    auto [U, S, Vt] = sketch.finalize();
+    ASSERT_EQ(U.get_shape(), std::make_pair(Size_T{200}, Size_T{6}));
+    auto S_exact = std::get<1>(SVD_decomposite(A));
+    double best = tail_norm(S_exact, 6);
+    ASSERT_MSG(norm_fro(compose(U, S, Vt) - A) < 1.5 * best, "Streaming sketch far from optimal.");
+    for (Size_T i = 0; i < 6; ++i) {
+        ASSERT_MSG(std::abs(S.at(i) - S_exact.at(i)) < 1e-3 * S_exact.at(0), "Singular value mismatch.");
+    }
+}
@@ -0,0 +1,136 @@
+#include "mat.hpp"
+
+using namespace matlib;
+
+void view_test();
+void level1_test();
+void gemv_test();
+void ger_test();
+void threaded_test();
+
+int main() {
+    view_test();
+    level1_test();
+    gemv_test();
+    ger_test();
+    threaded_test();
+
+    return 0;
+}
+
+void view_test() {
+    float data[] = {1,2,3,4,5,6};
+    Matrix<float> mat (2, 3, data);
+
+    auto row = mat.row(1);
+    auto col = mat.col(2);
+    ASSERT_EQ(row.size(), 3);
+    ASSERT_EQ(col.size(), 2);
+    ASSERT_EQ(row.at(0), 4);
+    ASSERT_EQ(col.at(0), 3);
+    ASSERT_EQ(col.at(1), 6);
+
+    col.at(1) = 2333;
+    ASSERT_EQ(mat.at(1, 2), 2333);
+
+    float expect[] = {3, 2333};
+    ASSERT_EQ(col.to_vec(), Vector<float>(2, expect));
+}
+
+void level1_test() {
+    float data1[] = {1,2,3,4,5,6,7,8,9,10};
+    float data2[] = {10,9,8,7,6,5,4,3,2,1};
+    Vector<float> v1 (10, data1);
+    Vector<float> v2 (10, data2);
+
+    ASSERT_EQ(dot(v1, v2), 220);
+
+    axpy(2.f, v1, v2);
+    float data3[] = {12,13,14,15,16,17,18,19,20,21};
+    ASSERT_EQ(v2, Vector<float>(10, data3));
+
+    scal(.5f, v2);
+    ASSERT_EQ(v2, Vector<float>(10, data3) * .5f);
+
+    float data4[] = {3, 4};
+    ASSERT_MSG(ValueEq(nrm2(Vector<float>(2, data4)), 5.f), "nrm2");
+    // sum of squares overflows a float, the result does not
+    float data5[] = {3e30f, 4e30f};
+    ASSERT_MSG(std::abs(nrm2(Vector<float>(2, data5)) / 5e30f - 1) < 1e-6f, "scaled nrm2");
+
+    // strided views
+    float data6[] = {1,2,3,4,5,6};
+    Matrix<float> mat (3, 2, data6);
+    ASSERT_EQ(dot(mat.col(0), mat.col(1)), 44);
+    ASSERT_EQ(dot(mat.row(2), mat.row(1)), 39);
+}
+
+void gemv_test() {
+    float data1[] = {1,2,3,4,5,6};
+    float data2[] = {1,0,-1};
+    Matrix<float> mat (2, 3, data1);
+    Vector<float> x (3, data2);
+
+    float data3[] = {-2, -2};
+    ASSERT_EQ(mat * x, Vector<float>(2, data3));
+    // matrix with a single column goes through the same kernel
+    ASSERT_EQ(mat * x.to_mat(), Vector<float>(2, data3).to_mat());
+    // column view of another matrix
+    float data6[] = {14, 32};
+    auto mat_T = mat.transpose();
+    ASSERT_EQ(mat * mat_T.col(0), Vector<float>(2, data6));
+
+    float data4[] = {1, 1};
+    float data5[] = {5, 7, 9};
+    ASSERT_EQ(Vector<float>(2, data4) * mat, Vector<float>(3, data5));
+
+    Vector<float> y (2, data4);
+    gemv(2.f, mat, x, 3.f, y);
+    float data7[] = {-1, -1};
+    ASSERT_EQ(y, Vector<float>(2, data7));
+}
+
+void ger_test() {
+    float data1[] = {1, 2};
+    float data2[] = {1, 2, 3};
+    Matrix<float> mat (2, 3);
+    ger(1.f, Vector<float>(2, data1), Vector<float>(3, data2), mat);
+
+    float data3[] = {1,2,3,2,4,6};
+    ASSERT_EQ(mat, Matrix<float>(2, 3, data3));
+}
+
+void threaded_test() {
+    set_num_threads(4);
+    Size_T n = 300000;
+    Vector<double> x (n), y (n);
+    for (Size_T i = 0; i < n; ++i) {
+        x.at(i) = 1;
+        y.at(i) = static_cast<double>(i % 7);
+    }
+    double expect = 0;
+    for (Size_T i = 0; i < n; ++i) {
+        expect += y.at(i);
+    }
+    ASSERT_EQ(dot(x, y), expect);
+
+    Matrix<double> A (400, 500);
+    Vector<double> v (500);
+    for (Size_T i = 0; i < 400; ++i) {
+        for (Size_T j = 0; j < 500; ++j) {
+            A.at(i, j) = static_cast<double>((i + j) % 5);
+        }
+    }
+    for (Size_T j = 0; j < 500; ++j) {
+        v.at(j) = 1;
+    }
+    auto Av = A * v;
+    auto vA = Vector<double>(400, std::vector<double>(400, 1.).data()) * A;
+    for (Size_T i = 0; i < 400; ++i) {
+        ASSERT_EQ(Av.at(i), 1000.);
+    }
+    for (Size_T j = 0; j < 500; ++j) {
+        ASSERT_EQ(vA.at(j), 800.);
+    }
+    set_num_threads(0);
+}